@@ -0,0 +1,96 @@
+// Adjacency lists as in bfs.cpp/dfs.cpp, stored three ways: std::vector,
+// Vector, and SmallVector with 8 inline neighbors. Most vertices of the
+// random graph have fewer than 8 edges, so the SmallVector graph needs
+// (almost) no allocation per vertex and keeps neighbors next to each other.
+// Measures building the graph and a BFS over it.
+//
+//   g++ -O2 -std=c++20 adjacency_benchmark.cpp && ./a.out 1000000 4
+#include "../stl/data-structure/SmallVector.h"
+#include "../stl/data-structure/Vector.h"
+
+#include <chrono>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+template <typename AdjacencyList> class Graph
+{
+  private:
+    std::vector<AdjacencyList> neighbors_;
+
+  public:
+    explicit Graph(int v) : neighbors_(v) {}
+
+    void add_edge(int v, int neighbor) { neighbors_[v].push_back(neighbor); }
+
+    // Number of vertices reached from v
+    int bfs(int v) const
+    {
+        std::vector<bool> visited(neighbors_.size(), false);
+        std::queue<int> next_vertices;
+        next_vertices.push(v);
+        visited[v] = true;
+        int reached = 0;
+
+        while (!next_vertices.empty()) {
+            int s = next_vertices.front();
+            next_vertices.pop();
+            ++reached;
+
+            for (int neighbor : neighbors_[s]) {
+                if (!visited[neighbor]) {
+                    next_vertices.push(neighbor);
+                    visited[neighbor] = true;
+                }
+            }
+        }
+        return reached;
+    }
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename AdjacencyList>
+void measure(const std::string &name, const std::vector<std::pair<int, int>> &edges,
+             int vertices)
+{
+    auto start = std::chrono::steady_clock::now();
+    Graph<AdjacencyList> graph(vertices);
+    for (auto [from, to] : edges) {
+        graph.add_edge(from, to);
+    }
+    double build = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    int reached = graph.bfs(0);
+    double bfs = seconds_since(start);
+
+    std::cout << name << ": build " << build * 1e3 << " ms, bfs " << bfs * 1e3
+              << " ms (" << reached << " reached)\n";
+}
+
+int main(int argc, char **argv)
+{
+    int vertices = argc > 1 ? std::stoi(argv[1]) : 1'000'000;
+    int degree = argc > 2 ? std::stoi(argv[2]) : 4;
+
+    // random directed edges, degree per vertex on average
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> vertex(0, vertices - 1);
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(static_cast<size_t>(vertices) * degree);
+    for (size_t i = 0; i < static_cast<size_t>(vertices) * degree; ++i) {
+        edges.emplace_back(vertex(rng), vertex(rng));
+    }
+
+    measure<std::vector<int>>("std::vector", edges, vertices);
+    measure<Vector<int>>("Vector", edges, vertices);
+    measure<SmallVector<int, 8>>("SmallVector<8>", edges, vertices);
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Throughput of the simd:: algorithms per instruction set, over a Vector of
+// int32_t and one of float, against a loop through Vector's bounds-checked
+// operator[]. The default size (16K elements) stays in L2; pass a larger one
+// to see memory bandwidth instead.
+//
+//   g++ -O2 -std=c++20 simd_benchmark.cpp && ./a.out 16384
+#include "../stl/data-structure/SimdAlgorithms.h"
+#include "../stl/data-structure/Vector.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+volatile int64_t g_sink; // keeps results alive
+
+template <typename F> double elements_per_ns(size_t n, F f)
+{
+    size_t rounds = std::max<size_t>(1, (size_t{1} << 28) / n);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+        g_sink = static_cast<int64_t>(f());
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+                                                         start).count();
+    return static_cast<double>(n) * rounds / ns;
+}
+
+template <typename T> void measure(const char *type, const Vector<T> &xs, const Vector<T> &ys)
+{
+    std::span<const T> a(xs.data(), xs.size());
+    std::span<const T> b(ys.data(), ys.size());
+    T missing = T(-1); // forces find to scan everything
+
+    std::printf("%-6s %-8s %8s %8s %8s %8s %8s  (elements/ns)\n", type, "isa", "find",
+                "count", "max", "sum", "dot");
+
+    // the loop the algorithms replace
+    auto checked_sum = [&] {
+        decltype(simd::sum(a)) total = 0;
+        for (size_t i = 0; i < xs.size(); ++i)
+            total += xs[i];
+        return total;
+    };
+    std::printf("%-6s %-8s %8s %8s %8s %8.2f %8s\n", type, "checked", "", "", "",
+                elements_per_ns(a.size(), checked_sum), "");
+
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::SSE42, simd::Isa::AVX2,
+                          simd::Isa::AVX512}) {
+        if (simd::force_isa(isa) != isa)
+            continue; // not supported here
+        std::printf("%-6s %-8s %8.2f %8.2f %8.2f %8.2f %8.2f\n", type, simd::isa_name(isa),
+                    elements_per_ns(a.size(), [&] { return simd::find(a, missing); }),
+                    elements_per_ns(a.size(), [&] { return simd::count(a, T(3)); }),
+                    elements_per_ns(a.size(), [&] { return simd::max(a); }),
+                    elements_per_ns(a.size(), [&] { return simd::sum(a); }),
+                    elements_per_ns(a.size(), [&] { return simd::dot(a, b); }));
+    }
+    simd::force_isa(simd::Isa::AVX512);
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 16384;
+
+    Vector<int32_t> ints(n), other_ints(n);
+    Vector<float> floats(n), other_floats(n);
+    for (size_t i = 0; i < n; ++i) {
+        ints[i] = static_cast<int32_t>(i % 1000);
+        other_ints[i] = static_cast<int32_t>(i % 7);
+        floats[i] = static_cast<float>(i % 1000);
+        other_floats[i] = static_cast<float>(i % 7);
+    }
+
+    std::printf("detected: %s, %zu elements\n", simd::isa_name(simd::detected_isa()), n);
+    measure("int32", ints, other_ints);
+    measure("float", floats, other_floats);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Per-item cost of handing 10k items to consumers one by one vs. in bulk:
+// QueueSafe::push vs. push_bulk/pop_bulk, ThreadPool::submit vs. submit_bulk.
+//
+//   g++ -O2 -std=c++20 -pthread bulk_benchmark.cpp threadpool.cpp task_graph.cpp timer_wheel.cpp
+#include "../stl/data-structure/QueueSafe.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F> void measure(const std::string &name, int items, F f)
+{
+    auto start = Clock::now();
+    f();
+    auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    std::cout << name << ": " << ns / items << " ns per item\n";
+}
+
+int main(int argc, char **argv)
+{
+    int items = argc > 1 ? std::stoi(argv[1]) : 10'000;
+    int rounds = 100;
+    std::vector<int> values(items, 1);
+
+    measure("QueueSafe push/pop", items * rounds, [&] {
+        QueueSafe<int> q;
+        std::thread consumer([&] {
+            for (int i = 0; i < items * rounds; ++i)
+                q.pop();
+        });
+        for (int r = 0; r < rounds; ++r) {
+            for (int v : values)
+                q.push(v);
+        }
+        consumer.join();
+    });
+    measure("QueueSafe push_bulk/pop_bulk", items * rounds, [&] {
+        QueueSafe<int> q;
+        std::thread consumer([&] {
+            for (size_t left = size_t(items) * rounds; left > 0;)
+                left -= q.pop_bulk(1024).size();
+        });
+        for (int r = 0; r < rounds; ++r)
+            q.push_bulk(values);
+        consumer.join();
+    });
+
+    ThreadPool pool(std::thread::hardware_concurrency());
+    std::vector<std::function<void()>> tasks(items, [] {});
+    measure("ThreadPool submit", items * rounds, [&] {
+        for (int r = 0; r < rounds; ++r) {
+            std::vector<std::future<void>> futures;
+            for (auto &task : tasks)
+                futures.push_back(pool.submit(task));
+            for (auto &future : futures)
+                future.get();
+        }
+    });
+    measure("ThreadPool submit_bulk", items * rounds, [&] {
+        for (int r = 0; r < rounds; ++r) {
+            for (auto &future : pool.submit_bulk(tasks))
+                future.get();
+        }
+    });
+    return 0;
+}
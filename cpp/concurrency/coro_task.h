@@ -0,0 +1,720 @@
+#pragma once
+#include "threadpool.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// C++20 coroutines on top of ThreadPool:
+//
+//   coro::task<int> handler(ThreadPool &pool)
+//   {
+//       co_await pool.schedule();          // continue on a pool worker
+//       auto [a, b] = co_await coro::when_all(fetch_a(), fetch_b());
+//       co_return a + b;
+//   }
+//
+// task<T> is lazy: it starts when awaited and resumes its awaiter by
+// symmetric transfer when done. Coroutine frames come from per-thread free
+// lists and go back to the list of the thread that created them, wherever
+// they finish, so creating tasks in a steady state does not call malloc.
+
+namespace coro
+{
+
+template <typename T = void> class task;
+
+namespace detail
+{
+
+// Per-thread cache of coroutine frames in power-of-two size classes. Each
+// frame carries a small header naming the cache it came from. A frame freed
+// on its owner's thread goes straight back on that cache's free list; one
+// freed on another thread (a task created here but finished on a worker) is
+// pushed onto the owner's lock-free return list, which the owner takes whole
+// the next time its free list of that class runs dry. So a thread that only
+// creates tasks still reuses its frames.
+//
+// When a thread exits, its cache is closed: cached and returned frames are
+// freed, and frames still out are freed by whoever releases them, the last
+// of which also frees the cache.
+class FramePool
+{
+  public:
+    static constexpr size_t MinSize = 64;
+    static constexpr size_t Classes = 7; // 64 B .. 4 KiB, header included
+    static constexpr size_t MaxCached = 256;
+
+    static void *allocate(size_t size)
+    {
+        size_t index = class_of(size + sizeof(Header));
+        if (index == Classes)
+            return ::operator new(size);
+        Cache &cache = local();
+        Header *frame = cache.heads[index];
+        if (frame) {
+            cache.heads[index] = frame->next;
+            --cache.counts[index];
+        } else if (!(frame = cache.reclaim(index))) {
+            frame = static_cast<Header *>(::operator new(MinSize << index));
+            frame->owner = &cache;
+        }
+        ++cache.live;
+        return frame + 1;
+    }
+
+    static void deallocate(void *ptr, size_t size) noexcept
+    {
+        size_t index = class_of(size + sizeof(Header));
+        if (index == Classes) {
+            ::operator delete(ptr);
+            return;
+        }
+        Header *frame = static_cast<Header *>(ptr) - 1;
+        Cache *owner = frame->owner;
+        if (owner == holder().cache)
+            owner->put(frame, index);
+        else
+            owner->give_back(frame, index);
+    }
+
+    // Frames on the calling thread's free lists (not counting returned ones)
+    static size_t cached() noexcept
+    {
+        size_t total = 0;
+        if (Cache *cache = holder().cache)
+            for (size_t count : cache->counts)
+                total += count;
+        return total;
+    }
+
+  private:
+    struct Cache;
+
+    // Keeps the frame itself at the default new alignment
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Header {
+        Cache *owner;
+        Header *next; // while on a free or return list
+    };
+
+    // Marks the return lists of a cache whose thread has exited
+    static inline Header Closed{};
+
+    struct Cache {
+        // owner thread only
+        Header *heads[Classes] = {};
+        size_t counts[Classes] = {};
+        size_t live = 0; // frames handed out and not yet back here
+
+        // pushed by other threads, taken whole by the owner
+        alignas(64) std::atomic<Header *> returned[Classes] = {};
+        std::atomic<ptrdiff_t> orphans{0};
+
+        void put(Header *frame, size_t index) noexcept
+        {
+            --live;
+            if (counts[index] == MaxCached) {
+                ::operator delete(frame);
+                return;
+            }
+            frame->next = heads[index];
+            heads[index] = frame;
+            ++counts[index];
+        }
+
+        // Refill from the return list; the first frame is handed out again
+        Header *reclaim(size_t index) noexcept
+        {
+            if (!returned[index].load(std::memory_order_relaxed))
+                return nullptr;
+            Header *first = returned[index].exchange(nullptr, std::memory_order_acquire);
+            --live;
+            for (Header *frame = first->next; frame;) {
+                Header *next = frame->next;
+                put(frame, index);
+                frame = next;
+            }
+            return first;
+        }
+
+        // Called on any thread but the owner's
+        void give_back(Header *frame, size_t index) noexcept
+        {
+            Header *head = returned[index].load(std::memory_order_relaxed);
+            do {
+                if (head == &Closed) {
+                    ::operator delete(frame);
+                    if (orphans.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        delete this;
+                    return;
+                }
+                frame->next = head;
+            } while (!returned[index].compare_exchange_weak(head, frame, std::memory_order_release,
+                                                            std::memory_order_relaxed));
+        }
+
+        // The owner thread exits. Frames given back after this are freed by
+        // give_back; orphans goes negative for those that beat the count.
+        void close() noexcept
+        {
+            for (size_t index = 0; index < Classes; ++index) {
+                release(heads[index]);
+                Header *list = returned[index].exchange(&Closed, std::memory_order_acquire);
+                for (Header *frame = list; frame; frame = frame->next)
+                    --live;
+                release(list);
+            }
+            auto outstanding = static_cast<ptrdiff_t>(live);
+            if (orphans.fetch_add(outstanding, std::memory_order_acq_rel) + outstanding == 0)
+                delete this;
+        }
+
+        static void release(Header *list) noexcept
+        {
+            while (list)
+                ::operator delete(std::exchange(list, list->next));
+        }
+    };
+
+    struct LocalCache {
+        Cache *cache = nullptr; // created by the first allocation
+        ~LocalCache()
+        {
+            if (cache)
+                cache->close();
+        }
+    };
+
+    static size_t class_of(size_t size) noexcept
+    {
+        size_t index = 0;
+        for (size_t limit = MinSize; limit < size && index < Classes; limit <<= 1)
+            ++index;
+        return index;
+    }
+
+    static LocalCache &holder() noexcept
+    {
+        thread_local LocalCache local;
+        return local;
+    }
+
+    static Cache &local()
+    {
+        LocalCache &local = holder();
+        if (!local.cache)
+            local.cache = new Cache;
+        return *local.cache;
+    }
+};
+
+struct PooledFrame {
+    static void *operator new(size_t size) { return FramePool::allocate(size); }
+    static void operator delete(void *ptr, size_t size) noexcept
+    {
+        FramePool::deallocate(ptr, size);
+    }
+};
+
+struct PromiseBase : PooledFrame {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+            auto next = h.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <typename T> struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    task<T> get_return_object() noexcept;
+
+    template <typename U> void return_value(U &&result)
+    {
+        value.emplace(std::forward<U>(result));
+    }
+
+    T take()
+    {
+        if (error)
+            std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <> struct Promise<void> : PromiseBase {
+    task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void take()
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+};
+
+// Eager, self-destroying coroutine used to drive tasks from plain code
+struct Detached {
+    struct promise_type : PooledFrame {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+template <typename T> class task
+{
+  public:
+    using promise_type = detail::Promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    task() noexcept = default;
+    explicit task(handle_type handle) noexcept : m_Handle(handle) {}
+
+    task(task &&other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+
+    task &operator=(task &&other) noexcept
+    {
+        if (this != &other) {
+            if (m_Handle)
+                m_Handle.destroy();
+            m_Handle = std::exchange(other.m_Handle, nullptr);
+        }
+        return *this;
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    ~task()
+    {
+        if (m_Handle)
+            m_Handle.destroy();
+    }
+
+    bool valid() const noexcept { return bool(m_Handle); }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter {
+            handle_type handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                if (!handle)
+                    throw std::logic_error("co_await on an empty task");
+                return handle.promise().take();
+            }
+        };
+        return Awaiter{m_Handle};
+    }
+
+  private:
+    handle_type m_Handle;
+};
+
+namespace detail
+{
+
+template <typename T> task<T> Promise<T>::get_return_object() noexcept
+{
+    return task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline task<void> Promise<void>::get_return_object() noexcept
+{
+    return task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+template <typename T> Detached drive_sync(task<T> work, std::promise<T> &result)
+{
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(work);
+            result.set_value();
+        } else {
+            result.set_value(co_await std::move(work));
+        }
+    } catch (...) {
+        result.set_exception(std::current_exception());
+    }
+}
+
+// Shared bookkeeping of when_all: children left plus one for the launcher,
+// so that the awaiting coroutine resumes exactly once, after the launch loop.
+struct AllState {
+    std::atomic<size_t> remaining{0};
+    std::coroutine_handle<> parent;
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    // The coroutine to continue with: the parent if this was the last one
+    std::coroutine_handle<> arrive() noexcept
+    {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            return parent;
+        return std::noop_coroutine();
+    }
+
+    void fail() noexcept
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+            error = std::current_exception();
+    }
+};
+
+// Lazy, self-destroying coroutine running one child of when_all. The last
+// one to finish transfers to the parent instead of resuming it nested.
+class AllChild
+{
+  public:
+    struct promise_type : PooledFrame {
+        AllState &state;
+
+        template <typename Work, typename... Rest>
+        promise_type(Work &, AllState &s, Rest &...) noexcept : state(s)
+        {
+        }
+
+        AllChild get_return_object() noexcept
+        {
+            return AllChild(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+            {
+                AllState &state = h.promise().state;
+                h.destroy();
+                return state.arrive();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    explicit AllChild(std::coroutine_handle<promise_type> handle) noexcept : m_Handle(handle) {}
+    AllChild(AllChild &&other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+    AllChild &operator=(AllChild &&) = delete;
+
+    // Never started: nothing ran, so nothing arrives either
+    ~AllChild()
+    {
+        if (m_Handle)
+            m_Handle.destroy();
+    }
+
+    std::coroutine_handle<> release() noexcept { return std::exchange(m_Handle, nullptr); }
+
+  private:
+    std::coroutine_handle<promise_type> m_Handle;
+};
+
+template <typename T> AllChild drive_all(task<T> work, AllState &state, std::optional<T> &slot)
+{
+    try {
+        slot.emplace(co_await std::move(work));
+    } catch (...) {
+        state.fail();
+    }
+}
+
+inline AllChild drive_all(task<void> work, AllState &state)
+{
+    try {
+        co_await std::move(work);
+    } catch (...) {
+        state.fail();
+    }
+}
+
+// Start a child on a pool worker, or right here without a pool (or if the
+// pool no longer takes work, since the parent is already committed to wait)
+inline void start_child(ThreadPool *pool, std::coroutine_handle<> child)
+{
+    if (pool) {
+        try {
+            pool->post([child] { child.resume(); });
+            return;
+        } catch (...) {
+        }
+    }
+    child.resume();
+}
+
+struct AllAwaiter {
+    AllState &state;
+    std::vector<AllChild> &children;
+    ThreadPool *pool;
+
+    bool await_ready() const noexcept { return children.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> parent)
+    {
+        state.parent = parent;
+        state.remaining.store(children.size() + 1, std::memory_order_relaxed);
+        for (auto &child : children)
+            start_child(pool, child.release());
+        // false: every child already finished, continue without suspending
+        return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const
+    {
+        if (state.error)
+            std::rethrow_exception(state.error);
+    }
+};
+
+template <typename T> task<std::vector<T>> all_of(ThreadPool *pool, std::vector<task<T>> tasks)
+{
+    AllState state;
+    std::vector<std::optional<T>> slots(tasks.size());
+    std::vector<AllChild> children;
+    children.reserve(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i)
+        children.push_back(drive_all(std::move(tasks[i]), state, slots[i]));
+    co_await AllAwaiter{state, children, pool};
+
+    std::vector<T> results;
+    results.reserve(slots.size());
+    for (auto &slot : slots)
+        results.push_back(std::move(*slot));
+    co_return results;
+}
+
+inline task<void> all_of(ThreadPool *pool, std::vector<task<void>> tasks)
+{
+    AllState state;
+    std::vector<AllChild> children;
+    children.reserve(tasks.size());
+    for (auto &work : tasks)
+        children.push_back(drive_all(std::move(work), state));
+    co_await AllAwaiter{state, children, pool};
+}
+
+template <typename T> task<void> store_into(task<T> work, std::optional<T> &slot)
+{
+    slot.emplace(co_await std::move(work));
+}
+
+// when_any outlives its awaiter: losers keep running after the winner
+// resumed the parent, so the state is shared with every child.
+template <typename T> struct AnyState {
+    std::atomic<bool> decided{false};
+    std::atomic<int> resumeGate{2}; // winner + launcher
+    std::coroutine_handle<> parent;
+    size_t index = 0;
+    std::optional<T> value;
+    std::exception_ptr error;
+
+    void open()
+    {
+        if (resumeGate.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            parent.resume();
+    }
+};
+
+template <> struct AnyState<void> {
+    std::atomic<bool> decided{false};
+    std::atomic<int> resumeGate{2};
+    std::coroutine_handle<> parent;
+    size_t index = 0;
+    std::exception_ptr error;
+
+    void open()
+    {
+        if (resumeGate.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            parent.resume();
+    }
+};
+
+template <typename T>
+Detached drive_any(task<T> work, std::shared_ptr<AnyState<T>> state, size_t index)
+{
+    std::exception_ptr error;
+    std::optional<T> value;
+    try {
+        value.emplace(co_await std::move(work));
+    } catch (...) {
+        error = std::current_exception();
+    }
+    if (!state->decided.exchange(true, std::memory_order_acq_rel)) {
+        state->index = index;
+        state->error = error;
+        state->value = std::move(value);
+        state->open();
+    }
+}
+
+inline Detached drive_any(task<void> work, std::shared_ptr<AnyState<void>> state,
+                          size_t index)
+{
+    std::exception_ptr error;
+    try {
+        co_await std::move(work);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    if (!state->decided.exchange(true, std::memory_order_acq_rel)) {
+        state->index = index;
+        state->error = error;
+        state->open();
+    }
+}
+
+// Holds references only: GCC 12 may destroy a co_await temporary twice, which
+// would drop an extra reference if the awaiter owned a shared_ptr.
+template <typename T> struct AnyAwaiter {
+    std::shared_ptr<AnyState<T>> &state;
+    std::vector<task<T>> &tasks;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> parent)
+    {
+        state->parent = parent;
+        for (size_t i = 0; i < tasks.size(); ++i)
+            drive_any(std::move(tasks[i]), state, i);
+        return state->resumeGate.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const
+    {
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+};
+
+} // namespace detail
+
+// Block the calling (non-pool) thread until the task completes
+template <typename T> T sync_wait(task<T> work)
+{
+    std::promise<T> result;
+    auto future = result.get_future();
+    detail::drive_sync(std::move(work), result);
+    return future.get();
+}
+
+// Await all tasks; results keep the order of the input and the first error
+// is rethrown once every task has finished. The tasks start one after
+// another on the awaiting thread, each running until its first suspension,
+// so they only overlap once they co_await pool.schedule() or similar. The
+// overloads taking a pool start every task on a worker instead.
+template <typename T> task<std::vector<T>> when_all(std::vector<task<T>> tasks)
+{
+    return detail::all_of(nullptr, std::move(tasks));
+}
+
+template <typename T>
+task<std::vector<T>> when_all(ThreadPool &pool, std::vector<task<T>> tasks)
+{
+    return detail::all_of(&pool, std::move(tasks));
+}
+
+inline task<void> when_all(std::vector<task<void>> tasks)
+{
+    return detail::all_of(nullptr, std::move(tasks));
+}
+
+inline task<void> when_all(ThreadPool &pool, std::vector<task<void>> tasks)
+{
+    return detail::all_of(&pool, std::move(tasks));
+}
+
+namespace detail
+{
+
+template <typename... Ts> task<std::tuple<Ts...>> all_of(ThreadPool *pool, task<Ts>... tasks)
+{
+    static_assert((!std::is_void_v<Ts> && ...), "use the vector overload for task<void>");
+    std::tuple<std::optional<Ts>...> slots;
+    std::vector<task<void>> children;
+    children.reserve(sizeof...(Ts));
+    std::apply([&](auto &...slot) { (children.push_back(store_into(std::move(tasks), slot)), ...); },
+               slots);
+    co_await all_of(pool, std::move(children));
+    co_return std::apply([](auto &...slot) { return std::tuple<Ts...>(std::move(*slot)...); },
+                         slots);
+}
+
+} // namespace detail
+
+template <typename... Ts> task<std::tuple<Ts...>> when_all(task<Ts>... tasks)
+{
+    return detail::all_of(nullptr, std::move(tasks)...);
+}
+
+template <typename... Ts> task<std::tuple<Ts...>> when_all(ThreadPool &pool, task<Ts>... tasks)
+{
+    return detail::all_of(&pool, std::move(tasks)...);
+}
+
+// Resume as soon as the first task finishes; yields its index and result.
+// The other tasks still run to completion in the background.
+template <typename T> task<std::pair<size_t, T>> when_any(std::vector<task<T>> tasks)
+{
+    if (tasks.empty())
+        throw std::invalid_argument("when_any needs at least one task");
+    auto state = std::make_shared<detail::AnyState<T>>();
+    co_await detail::AnyAwaiter<T>{state, tasks};
+    co_return std::pair<size_t, T>(state->index, std::move(*state->value));
+}
+
+inline task<size_t> when_any(std::vector<task<void>> tasks)
+{
+    if (tasks.empty())
+        throw std::invalid_argument("when_any needs at least one task");
+    auto state = std::make_shared<detail::AnyState<void>>();
+    co_await detail::AnyAwaiter<void>{state, tasks};
+    co_return state->index;
+}
+
+} // namespace coro
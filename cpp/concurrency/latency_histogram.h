@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear (HDR-style) histogram of durations in nanoseconds.
+// Every power of two is split into 2^SubBucketBits linear sub-buckets, so the
+// relative error of a reported percentile is bounded by 1 / 2^SubBucketBits.
+// Recording is a single relaxed atomic increment and never allocates.
+class LatencyHistogram
+{
+  public:
+    static constexpr unsigned SubBucketBits = 3;
+    static constexpr size_t SubBuckets = size_t(1) << SubBucketBits;
+    static constexpr size_t BucketCount = (64 - SubBucketBits + 1) * SubBuckets;
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram &other) { add(other); }
+
+    LatencyHistogram &operator=(const LatencyHistogram &other)
+    {
+        if (this != &other) {
+            reset();
+            add(other);
+        }
+        return *this;
+    }
+
+    void record(uint64_t nanoseconds) noexcept
+    {
+        m_Counts[index_of(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Same as record() for a histogram that only the calling thread writes
+    // (readers may still run concurrently): a load and a store instead of a
+    // locked read-modify-write.
+    void record_exclusive(uint64_t nanoseconds) noexcept
+    {
+        auto &count = m_Counts[index_of(nanoseconds)];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> duration) noexcept
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        record(ns > 0 ? uint64_t(ns) : 0);
+    }
+
+    // Merge another histogram into this one (used to aggregate per-thread data)
+    void add(const LatencyHistogram &other) noexcept
+    {
+        for (size_t i = 0; i < BucketCount; ++i) {
+            auto n = other.m_Counts[i].load(std::memory_order_relaxed);
+            if (n)
+                m_Counts[i].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    void reset() noexcept
+    {
+        for (auto &count : m_Counts)
+            count.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const noexcept
+    {
+        uint64_t total = 0;
+        for (const auto &count : m_Counts)
+            total += count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Upper bound of the bucket holding the p-th percentile (p in [0, 100])
+    uint64_t percentile(double p) const noexcept
+    {
+        uint64_t total = count();
+        if (total == 0)
+            return 0;
+
+        auto rank = uint64_t(p / 100.0 * double(total) + 0.5);
+        if (rank == 0)
+            rank = 1;
+        if (rank > total)
+            rank = total;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BucketCount; ++i) {
+            seen += m_Counts[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+                return upper_bound_of(i);
+        }
+        return upper_bound_of(BucketCount - 1);
+    }
+
+    uint64_t max() const noexcept
+    {
+        for (size_t i = BucketCount; i-- > 0;) {
+            if (m_Counts[i].load(std::memory_order_relaxed))
+                return upper_bound_of(i);
+        }
+        return 0;
+    }
+
+  private:
+    static size_t index_of(uint64_t value) noexcept
+    {
+        if (value < SubBuckets)
+            return size_t(value);
+        unsigned exponent = 63u - unsigned(__builtin_clzll(value));
+        unsigned shift = exponent - SubBucketBits;
+        return (shift + 1) * SubBuckets + size_t((value >> shift) - SubBuckets);
+    }
+
+    static uint64_t upper_bound_of(size_t index) noexcept
+    {
+        if (index < SubBuckets)
+            return index;
+        size_t shift = index / SubBuckets - 1;
+        uint64_t base = (SubBuckets + index % SubBuckets) << shift;
+        return base + ((uint64_t(1) << shift) - 1);
+    }
+
+    std::array<std::atomic<uint64_t>, BucketCount> m_Counts{};
+};
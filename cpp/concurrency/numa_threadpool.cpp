@@ -0,0 +1,161 @@
+#include "numa_threadpool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+std::vector<int> parse_cpu_list(const std::string &list)
+{
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty())
+            continue;
+        auto dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+static bool read_line(const std::string &path, std::string &line)
+{
+    std::ifstream file(path);
+    return file && std::getline(file, line);
+}
+
+NumaTopology NumaTopology::detect(const std::string &root)
+{
+    NumaTopology topology;
+    std::string online;
+    if (read_line(root + "/online", online)) {
+        for (int node : parse_cpu_list(online)) {
+            std::string line;
+            if (!read_line(root + "/node" + std::to_string(node) + "/cpulist", line))
+                continue;
+            auto cpus = parse_cpu_list(line);
+            if (cpus.empty())
+                continue; // memory-only node
+            topology.cpus.push_back(std::move(cpus));
+
+            std::vector<int> distance;
+            if (read_line(root + "/node" + std::to_string(node) + "/distance", line)) {
+                std::stringstream stream(line);
+                for (int d; stream >> d;)
+                    distance.push_back(d);
+            }
+            topology.distance.push_back(std::move(distance));
+        }
+    }
+
+    if (topology.cpus.empty()) {
+        std::vector<int> all(std::max(1u, std::thread::hardware_concurrency()));
+        std::iota(all.begin(), all.end(), 0);
+        topology.cpus = {all};
+        topology.distance.clear();
+    }
+    // distances are indexed by kernel node id; only keep them if they line up
+    for (const auto &row : topology.distance) {
+        if (row.size() != topology.cpus.size()) {
+            topology.distance.clear();
+            break;
+        }
+    }
+    return topology;
+}
+
+size_t NumaTopology::node_of_cpu(int cpu) const noexcept
+{
+    for (size_t node = 0; node < cpus.size(); ++node) {
+        if (std::find(cpus[node].begin(), cpus[node].end(), cpu) != cpus[node].end())
+            return node;
+    }
+    return cpus.size();
+}
+
+NumaThreadPool::NumaThreadPool(size_t workersPerNode, NumaTopology topology)
+    : m_Topology(std::move(topology))
+{
+    const size_t nodes = m_Topology.nodes();
+    if (nodes == 0)
+        throw std::invalid_argument("NumaThreadPool needs at least one node");
+
+    for (size_t node = 0; node < nodes; ++node) {
+        std::vector<size_t> victims;
+        for (size_t other = 0; other < nodes; ++other) {
+            if (other != node)
+                victims.push_back(other);
+        }
+        if (!m_Topology.distance.empty()) {
+            const auto &row = m_Topology.distance[node];
+            std::stable_sort(victims.begin(), victims.end(),
+                             [&row](size_t a, size_t b) { return row[a] < row[b]; });
+        }
+        m_Victims.push_back(std::move(victims));
+    }
+
+    for (size_t node = 0; node < nodes; ++node) {
+        ThreadPool::Options options;
+        options.numberOfWorker =
+            workersPerNode ? workersPerNode : m_Topology.cpus[node].size();
+        options.cpuSet = m_Topology.cpus[node];
+        if (nodes > 1)
+            options.onIdle = [this, node] { return Steal(node); };
+        m_Pools.push_back(std::make_unique<ThreadPool>(options));
+    }
+    m_Running = true;
+}
+
+NumaThreadPool::~NumaThreadPool()
+{
+    // stop cross-node stealing before any pool goes away
+    m_Running = false;
+    while (m_Stealing.load() != 0)
+        std::this_thread::yield();
+    m_Pools.clear();
+}
+
+ThreadPool &NumaThreadPool::node_pool(size_t node)
+{
+    if (node >= m_Pools.size())
+        throw std::out_of_range("NUMA node out of range");
+    return *m_Pools[node];
+}
+
+size_t NumaThreadPool::current_node() const noexcept
+{
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    size_t node = cpu < 0 ? m_Pools.size() : m_Topology.node_of_cpu(cpu);
+    return node < m_Pools.size() ? node : 0;
+#else
+    return 0;
+#endif
+}
+
+bool NumaThreadPool::Steal(size_t thief)
+{
+    ++m_Stealing;
+    bool found = false;
+    if (m_Running) {
+        for (size_t victim : m_Victims[thief]) {
+            if (m_Pools[victim]->try_run_one()) {
+                found = true;
+                break;
+            }
+        }
+    }
+    --m_Stealing;
+    return found;
+}
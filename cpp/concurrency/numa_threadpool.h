@@ -0,0 +1,73 @@
+#pragma once
+#include "threadpool.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Parse a kernel cpu list such as "0-3,8,10-11"
+std::vector<int> parse_cpu_list(const std::string &list);
+
+// CPUs and inter-node distances of the NUMA nodes of the machine
+struct NumaTopology {
+    std::vector<std::vector<int>> cpus;     // cpus[node]
+    std::vector<std::vector<int>> distance; // distance[from][to], may be empty
+
+    // Read /sys/devices/system/node; falls back to a single node holding all
+    // CPUs when the directory is not available.
+    static NumaTopology detect(const std::string &root = "/sys/devices/system/node");
+
+    size_t nodes() const noexcept { return cpus.size(); }
+
+    // Node owning the cpu, or nodes() when unknown
+    size_t node_of_cpu(int cpu) const noexcept;
+};
+
+// One ThreadPool per NUMA node with its workers confined to the node's CPUs.
+// Submissions go to the pool of the node the caller runs on. A worker whose
+// own pool is empty steals from the other nodes, nearest node first.
+class NumaThreadPool
+{
+  public:
+    // workersPerNode == 0 means one worker per CPU of the node
+    explicit NumaThreadPool(size_t workersPerNode = 0,
+                            NumaTopology topology = NumaTopology::detect());
+
+    ~NumaThreadPool();
+
+    NumaThreadPool(const NumaThreadPool &) = delete;
+    NumaThreadPool &operator=(const NumaThreadPool &) = delete;
+
+    template <typename F> auto submit(F &&f)
+    {
+        return m_Pools[current_node()]->submit(std::forward<F>(f));
+    }
+
+    template <typename F> auto submit(size_t lane, F &&f)
+    {
+        return m_Pools[current_node()]->submit(lane, std::forward<F>(f));
+    }
+
+    template <typename F> auto submit_on(size_t node, F &&f)
+    {
+        return node_pool(node).submit(std::forward<F>(f));
+    }
+
+    size_t nodes() const noexcept { return m_Pools.size(); }
+    ThreadPool &node_pool(size_t node);
+    const NumaTopology &topology() const noexcept { return m_Topology; }
+
+    // Node of the CPU the calling thread is currently running on
+    size_t current_node() const noexcept;
+
+  private:
+    bool Steal(size_t thief);
+
+  private:
+    NumaTopology m_Topology;
+    std::vector<std::vector<size_t>> m_Victims; // other nodes, nearest first
+    std::vector<std::unique_ptr<ThreadPool>> m_Pools;
+    std::atomic<bool> m_Running{false};
+    std::atomic<size_t> m_Stealing{0};
+};
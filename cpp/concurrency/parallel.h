@@ -0,0 +1,227 @@
+#pragma once
+#include "threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Data-parallel loops that run on ThreadPool workers instead of spawning a
+// thread per split. Ranges are divided by lazy binary splitting: a task walks
+// its range grain by grain and only hands the upper half of what is left to
+// the pool when the pool looks hungry (fewer queued tasks than workers). On a
+// busy pool the work therefore stays in large sequential chunks, on an idle
+// one it spreads out in log(n) steps.
+//
+// The calling thread helps running pool tasks while it waits, so these can
+// be nested and called from inside pool tasks. Once nothing is left to help
+// with, a thread from outside the pool parks until the last task finishes;
+// a worker keeps polling instead, since parking every worker in nested
+// waits would leave nobody to run the tasks they wait for.
+
+namespace parallel_detail
+{
+
+// Outstanding spawned tasks of one parallel call plus their first exception
+struct Join {
+    std::atomic<size_t> outstanding{0};
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    void fail(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+            error = std::move(e);
+    }
+
+    // Called by every spawned task when it is done
+    void finish() noexcept
+    {
+        if (outstanding.fetch_sub(1, std::memory_order_release) == 1)
+            outstanding.notify_all();
+    }
+
+    void wait(ThreadPool &pool)
+    {
+        bool worker = ThreadPool::current() == &pool;
+        while (size_t left = outstanding.load(std::memory_order_acquire)) {
+            if (pool.try_run_one())
+                continue;
+            if (worker)
+                std::this_thread::yield();
+            else
+                outstanding.wait(left, std::memory_order_acquire);
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+};
+
+inline size_t default_grain(const ThreadPool &pool, size_t n)
+{
+    size_t grain = n / (pool.size() * 64 + 1);
+    return std::clamp<size_t>(grain, 1, 4096);
+}
+
+// Run leaf(state, b, e) over [first, last) with lazy binary splitting. Each
+// task owns one State; its leaves run in ascending order and together cover
+// [first, x) for the x it ends at. done(first, state) is then called once
+// per task, so the states keyed by first partition the whole range.
+template <typename State, typename Leaf, typename Done>
+void split_run(ThreadPool &pool, Join &join, size_t first, size_t last, size_t grain,
+               const Leaf &leaf, const Done &done)
+{
+    try {
+        State state{};
+        size_t begin = first;
+        while (last - begin > grain) {
+            if (pool.pending() < pool.size()) {
+                size_t mid = begin + (last - begin) / 2;
+                join.outstanding.fetch_add(1, std::memory_order_relaxed);
+                try {
+                    pool.post([&pool, &join, mid, last, grain, &leaf, &done] {
+                        split_run<State>(pool, join, mid, last, grain, leaf, done);
+                        join.finish();
+                    });
+                } catch (...) {
+                    join.outstanding.fetch_sub(1, std::memory_order_relaxed);
+                    throw;
+                }
+                last = mid;
+            } else {
+                leaf(state, begin, begin + grain);
+                begin += grain;
+            }
+        }
+        if (begin < last)
+            leaf(state, begin, last);
+        done(first, std::move(state));
+    } catch (...) {
+        join.fail(std::current_exception());
+    }
+}
+
+struct NoState {
+};
+
+} // namespace parallel_detail
+
+// Call f(i) for every i in [first, last)
+template <typename Index, typename F>
+void parallel_for(ThreadPool &pool, Index first, Index last, F f, size_t grain = 0)
+{
+    if (!(first < last))
+        return;
+    size_t n = size_t(last - first);
+    if (grain == 0)
+        grain = parallel_detail::default_grain(pool, n);
+
+    parallel_detail::Join join;
+    auto leaf = [&f, first](parallel_detail::NoState &, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+            f(Index(first + i));
+    };
+    auto done = [](size_t, parallel_detail::NoState &&) {};
+    parallel_detail::split_run<parallel_detail::NoState>(pool, join, 0, n, grain, leaf,
+                                                         done);
+    join.wait(pool);
+}
+
+// Fold [first, last) into init with an associative op. Partial results are
+// combined in range order, so op does not need to be commutative.
+template <typename RandomIt, typename T, typename BinaryOp>
+T parallel_reduce(ThreadPool &pool, RandomIt first, RandomIt last, T init, BinaryOp op,
+                  size_t grain = 0)
+{
+    auto n = size_t(std::distance(first, last));
+    if (n == 0)
+        return init;
+    if (grain == 0)
+        grain = parallel_detail::default_grain(pool, n);
+
+    using Partial = std::optional<T>;
+    std::mutex mutex;
+    std::vector<std::pair<size_t, Partial>> partials;
+    parallel_detail::Join join;
+
+    auto leaf = [&op, first](Partial &partial, size_t b, size_t e) {
+        T acc = partial ? std::move(*partial) : T(first[b++]);
+        for (size_t i = b; i < e; ++i)
+            acc = op(std::move(acc), first[i]);
+        partial = std::move(acc);
+    };
+    auto done = [&mutex, &partials](size_t begin, Partial &&partial) {
+        std::lock_guard<std::mutex> lock(mutex);
+        partials.emplace_back(begin, std::move(partial));
+    };
+    parallel_detail::split_run<Partial>(pool, join, 0, n, grain, leaf, done);
+    join.wait(pool);
+
+    std::sort(partials.begin(), partials.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (auto &partial : partials) {
+        if (partial.second)
+            init = op(std::move(init), std::move(*partial.second));
+    }
+    return init;
+}
+
+// Inclusive scan of [first, last) into d_first, seeded with init. Two passes
+// over chunks: the first reduces the range with the same lazy splitting as
+// parallel_reduce, each task's share becoming a chunk; the chunk totals are
+// scanned, then every chunk is scanned again starting from its offset.
+template <typename RandomIt, typename OutputIt, typename T, typename BinaryOp>
+OutputIt parallel_scan(ThreadPool &pool, RandomIt first, RandomIt last, OutputIt d_first,
+                       T init, BinaryOp op, size_t grain = 0)
+{
+    auto n = size_t(std::distance(first, last));
+    if (n == 0)
+        return d_first;
+    if (grain == 0)
+        grain = parallel_detail::default_grain(pool, n);
+
+    using Partial = std::optional<T>;
+    std::mutex mutex;
+    std::vector<std::pair<size_t, Partial>> chunks;
+    parallel_detail::Join join;
+
+    auto leaf = [&op, first](Partial &partial, size_t b, size_t e) {
+        T acc = partial ? std::move(*partial) : T(first[b++]);
+        for (size_t i = b; i < e; ++i)
+            acc = op(std::move(acc), first[i]);
+        partial = std::move(acc);
+    };
+    auto done = [&mutex, &chunks](size_t begin, Partial &&partial) {
+        std::lock_guard<std::mutex> lock(mutex);
+        chunks.emplace_back(begin, std::move(partial));
+    };
+    parallel_detail::split_run<Partial>(pool, join, 0, n, grain, leaf, done);
+    join.wait(pool);
+
+    // chunk k covers [chunks[k].first, chunks[k + 1].first)
+    std::sort(chunks.begin(), chunks.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+    std::vector<T> offsets;
+    offsets.reserve(chunks.size());
+    offsets.push_back(init);
+    for (size_t k = 0; k + 1 < chunks.size(); ++k)
+        offsets.push_back(op(offsets.back(), *chunks[k].second));
+
+    parallel_for(pool, size_t(0), chunks.size(), [&](size_t k) {
+        size_t b = chunks[k].first;
+        size_t e = k + 1 < chunks.size() ? chunks[k + 1].first : n;
+        T acc = offsets[k];
+        for (size_t i = b; i < e; ++i) {
+            acc = op(std::move(acc), first[i]);
+            d_first[i] = acc;
+        }
+    }, 1);
+
+    return d_first + n;
+}
@@ -0,0 +1,55 @@
+// Reduction of 100M elements: std::accumulate vs. the std::async based
+// parallel_sum from async.cpp vs. parallel_reduce on a ThreadPool.
+//
+//   g++ -O2 -std=c++20 -pthread parallel_benchmark.cpp threadpool.cpp task_graph.cpp timer_wheel.cpp
+#include "parallel.h"
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Same as async.cpp: one std::async (one OS thread) per split
+template <typename RandomIt> long long parallel_sum(RandomIt beg, RandomIt end)
+{
+    auto len = end - beg;
+    if (len < 1000)
+        return std::accumulate(beg, end, 0LL);
+
+    RandomIt mid = beg + len / 2;
+    auto right = std::async(std::launch::async, parallel_sum<RandomIt>, mid, end);
+    auto left = std::async(std::launch::async, parallel_sum<RandomIt>, beg, mid);
+    return left.get() + right.get();
+}
+
+template <typename F> void measure(const std::string &name, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    try {
+        long long sum = f();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        std::cout << name << ": sum = " << sum << " in " << elapsed.count() << " ms\n";
+    } catch (const std::system_error &e) {
+        // the async version runs out of threads long before it runs out of work
+        std::cout << name << ": failed (" << e.what() << ")\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? std::stoull(argv[1]) : 100'000'000;
+    std::vector<int> v(n, 1);
+    ThreadPool pool(std::thread::hardware_concurrency());
+
+    measure("std::accumulate", [&v] { return std::accumulate(v.begin(), v.end(), 0LL); });
+    measure("parallel_reduce", [&] {
+        return parallel_reduce(pool, v.begin(), v.end(), 0LL, std::plus<>());
+    });
+    measure("parallel_sum (std::async)",
+            [&v] { return parallel_sum(v.begin(), v.end()); });
+    return 0;
+}
@@ -1,48 +1,47 @@
+#include "../stl/data-structure/QueueSafe.h"
+
 #include <chrono>
-#include <condition_variable>
 #include <iostream>
 #include <mutex>
-#include <queue>
 #include <thread>
 
-std::queue<int> buffer;                // Shared buffer
 const unsigned int maxBufferSize = 10; // Maximum buffer size
 
-std::mutex mtx;                      // Mutex for critical section
-std::condition_variable cv_producer; // Condition variable for producer
-std::condition_variable cv_consumer; // Condition variable for consumer
+// Shared buffer: producers block while it is full, consumers while it is empty
+QueueSafe<int> buffer(maxBufferSize, OverflowPolicy::Block);
 
-bool done = false; // Flag to stop the process
+std::mutex coutMtx; // Keeps the output lines whole
 
 void producer(int id)
 {
     int data = 0;
-    while (!done) {
-        std::unique_lock<std::mutex> lock(mtx);
-        cv_producer.wait(lock, [] { return buffer.size() < maxBufferSize; });
-
-        buffer.push(data);
-        std::cout << "Producer " << id << " produced " << data++ << std::endl;
-
-        lock.unlock();
-        cv_consumer.notify_all(); // Notify consumer that data is available
-        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Simulate work
+    try {
+        while (true) {
+            buffer.push(data); // Blocks while the buffer is full (backpressure)
+            {
+                std::lock_guard<std::mutex> lock(coutMtx);
+                std::cout << "Producer " << id << " produced " << data++ << std::endl;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Simulate work
+        }
+    } catch (const QueueClosed &) {
+        // Stop producing once the buffer is closed
     }
 }
 
 void consumer(int id)
 {
-    while (!done) {
-        std::unique_lock<std::mutex> lock(mtx);
-        cv_consumer.wait(lock, [] { return !buffer.empty(); });
-
-        int data = buffer.front();
-        buffer.pop();
-        std::cout << "Consumer " << id << " consumed " << data << std::endl;
-
-        lock.unlock();
-        cv_producer.notify_all(); // Notify producer that space is available
-        std::this_thread::sleep_for(std::chrono::milliseconds(150)); // Simulate work
+    try {
+        while (true) {
+            int data = buffer.pop(); // Blocks while the buffer is empty
+            {
+                std::lock_guard<std::mutex> lock(coutMtx);
+                std::cout << "Consumer " << id << " consumed " << data << std::endl;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(150)); // Simulate work
+        }
+    } catch (const QueueClosed &) {
+        // Closed and drained: nothing left to consume
     }
 }
 
@@ -54,7 +53,7 @@ int main()
     std::thread c2(consumer, 2);
 
     std::this_thread::sleep_for(std::chrono::seconds(2));
-    done = true; // Stop the threads after some time
+    buffer.close(); // Stop the threads after some time; wakes every waiter
 
     p1.join();
     p2.join();
@@ -0,0 +1,43 @@
+// Mixed producer/consumer throughput of QueueSafe (one lock for both ends)
+// vs. QueueTwoLock (head and tail locks), N producers and N consumers.
+//
+//   g++ -O2 -std=c++20 -pthread queue_benchmark.cpp && ./a.out 2
+#include "../stl/data-structure/QueueSafe.h"
+#include "../stl/data-structure/QueueTwoLock.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+template <typename Q> void measure(const std::string &name, int pairs, int items)
+{
+    Q queue;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < pairs; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < items; ++i)
+                queue.push(i);
+        });
+        threads.emplace_back([&] {
+            for (int i = 0; i < items; ++i)
+                queue.pop();
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << pairs * items / seconds / 1e6 << " M items/s\n";
+}
+
+int main(int argc, char **argv)
+{
+    int pairs = argc > 1 ? std::stoi(argv[1]) : 2;
+    int items = argc > 2 ? std::stoi(argv[2]) : 1'000'000;
+    measure<QueueSafe<int>>("QueueSafe", pairs, items);
+    measure<QueueTwoLock<int>>("QueueTwoLock", pairs, items);
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Round-trip latency of a ping-pong between two threads, once with blocking
+// waits only and once spinning before parking (SpinPolicy). With spinning the
+// hand-off skips the futex wake-up and the context switch on both sides.
+// Run it on a machine with at least two cores, otherwise nothing spins.
+//
+//   g++ -O2 -std=c++20 -pthread spin_wait_benchmark.cpp threadpool.cpp task_graph.cpp timer_wheel.cpp
+#include "../stl/data-structure/QueueSafe.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static void report(const std::string &name, Clock::duration elapsed, int rounds)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    std::cout << name << ": " << ns / rounds << " ns per round trip\n";
+}
+
+static void queue_ping_pong(const std::string &name, SpinPolicy spin, int rounds)
+{
+    QueueSafe<int> ping(spin), pong(spin);
+    std::thread echo([&] {
+        for (int i = 0; i < rounds; ++i)
+            pong.push(ping.pop());
+    });
+
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        ping.push(i);
+        pong.pop();
+    }
+    report(name, Clock::now() - start, rounds);
+    echo.join();
+}
+
+static void pool_ping_pong(const std::string &name, SpinPolicy spin, int rounds)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.spin = spin;
+    ThreadPool pool(options);
+
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i)
+        pool.submit([i] { return i; }).get();
+    report(name, Clock::now() - start, rounds);
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = argc > 1 ? std::stoi(argv[1]) : 100'000;
+
+    queue_ping_pong("QueueSafe, park only", SpinPolicy::none(), rounds);
+    queue_ping_pong("QueueSafe, spin then park", SpinPolicy{}, rounds);
+    // the future's get() still parks, so only the worker side spins here
+    pool_ping_pong("ThreadPool, park only", SpinPolicy::none(), rounds);
+    pool_ping_pong("ThreadPool, spin then park", SpinPolicy{}, rounds);
+    return 0;
+}
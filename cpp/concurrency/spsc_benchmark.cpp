@@ -0,0 +1,65 @@
+// Items per second through a SpscRing between two threads, one item at a
+// time and in batches. Pin the threads to two cores for stable numbers:
+//
+//   g++ -O2 -std=c++20 -pthread spsc_benchmark.cpp && taskset -c 2,3 ./a.out
+#include "../stl/data-structure/SpscRing.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Producer, typename Consumer>
+void measure(const std::string &name, size_t items, Producer produce, Consumer consume)
+{
+    auto start = Clock::now();
+    std::thread producer(produce);
+    consume();
+    producer.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << name << ": " << items / seconds / 1e6 << " M items/s\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t items = argc > 1 ? std::stoull(argv[1]) : 50'000'000;
+    SpscRing<long> ring(4096);
+
+    measure(
+        "try_push/try_pop", items,
+        [&] {
+            for (size_t i = 0; i < items;) {
+                if (ring.try_push(long(i)))
+                    ++i;
+            }
+        },
+        [&] {
+            long value, sum = 0;
+            for (size_t i = 0; i < items;) {
+                if (ring.try_pop(value)) {
+                    sum += value;
+                    ++i;
+                }
+            }
+            if (sum == 42)
+                std::cout << "";
+        });
+
+    measure(
+        "write/read (batches of 256)", items,
+        [&] {
+            std::vector<long> batch(256, 1);
+            for (size_t i = 0; i < items;)
+                i += ring.write(std::span<const long>(batch.data(),
+                                                      std::min(batch.size(), items - i)));
+        },
+        [&] {
+            std::vector<long> batch(256);
+            for (size_t i = 0; i < items;)
+                i += ring.read(batch);
+        });
+    return 0;
+}
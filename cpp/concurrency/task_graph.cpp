@@ -0,0 +1,159 @@
+#include "task_graph.h"
+
+#include "threadpool.h"
+
+#include <stdexcept>
+#include <utility>
+
+TaskGraph::NodeId TaskGraph::add(std::function<void()> work)
+{
+    if (running())
+        throw std::logic_error("TaskGraph cannot change while running");
+    m_Nodes.emplace_back();
+    m_Nodes.back().work = std::move(work);
+    m_Validated = false;
+    return m_Nodes.size() - 1;
+}
+
+void TaskGraph::precede(NodeId before, NodeId after)
+{
+    if (running())
+        throw std::logic_error("TaskGraph cannot change while running");
+    if (before >= m_Nodes.size() || after >= m_Nodes.size())
+        throw std::out_of_range("TaskGraph node out of range");
+    m_Nodes[before].successors.push_back(after);
+    ++m_Nodes[after].dependencies;
+    m_Validated = false;
+}
+
+// Collect the roots and reject cycles (Kahn's algorithm). Only runs after
+// the graph changed, so repeated runs of the same graph skip it.
+void TaskGraph::Validate()
+{
+    if (m_Validated)
+        return;
+
+    std::vector<size_t> indegree(m_Nodes.size());
+    std::vector<NodeId> ready;
+    for (NodeId id = 0; id < m_Nodes.size(); ++id) {
+        indegree[id] = m_Nodes[id].dependencies;
+        if (indegree[id] == 0)
+            ready.push_back(id);
+    }
+    m_Roots = ready;
+
+    size_t visited = 0;
+    while (!ready.empty()) {
+        NodeId id = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (NodeId next : m_Nodes[id].successors) {
+            if (--indegree[next] == 0)
+                ready.push_back(next);
+        }
+    }
+    if (visited != m_Nodes.size())
+        throw std::logic_error("TaskGraph contains a cycle");
+    m_Validated = true;
+}
+
+std::future<void> TaskGraph::Start(ThreadPool &pool, size_t lane)
+{
+    // refuse up front what post() would refuse, before any state changes
+    if (lane >= pool.lanes())
+        throw std::out_of_range("ThreadPool lane out of range");
+    if (ThreadPool::current() != &pool && pool.stopped())
+        throw std::runtime_error("ThreadPool is stopped");
+    if (m_Running.exchange(true, std::memory_order_acq_rel))
+        throw std::logic_error("TaskGraph is already running");
+
+    std::future<void> done;
+    try {
+        Validate();
+        for (auto &node : m_Nodes)
+            node.remaining.store(node.dependencies, std::memory_order_relaxed);
+        m_Unfinished.store(m_Nodes.size(), std::memory_order_relaxed);
+        m_Failed.store(false, std::memory_order_relaxed);
+        m_Error = nullptr;
+        m_Done = std::promise<void>();
+        m_Pool = &pool;
+        m_Lane = lane;
+        done = m_Done.get_future();
+    } catch (...) {
+        m_Running.store(false, std::memory_order_release);
+        throw;
+    }
+
+    if (m_Nodes.empty()) {
+        auto promise = std::move(m_Done);
+        m_Running.store(false, std::memory_order_release);
+        promise.set_value();
+        return done;
+    }
+
+    // the release of each post publishes the reset counters to the workers.
+    // Once the last root is scheduled the run may finish and the graph be
+    // reused, so m_Roots is not touched after that.
+    size_t roots = m_Roots.size();
+    for (size_t i = 0; i < roots; ++i)
+        Schedule(m_Roots[i]);
+    return done;
+}
+
+// Post a ready node. If the pool refuses (it began stopping, or is out of
+// memory), fail the run and walk the node here: its work is skipped, but its
+// successors are still counted down, so the run completes.
+void TaskGraph::Schedule(NodeId id)
+{
+    try {
+        m_Pool->post(m_Lane, [this, id] { Execute(id); });
+    } catch (...) {
+        Fail(std::current_exception());
+        Execute(id);
+    }
+}
+
+void TaskGraph::Fail(std::exception_ptr error)
+{
+    if (!m_Failed.exchange(true))
+        m_Error = std::move(error);
+}
+
+void TaskGraph::Execute(NodeId id)
+{
+    while (true) {
+        Node &node = m_Nodes[id];
+        if (!m_Failed.load(std::memory_order_relaxed) && node.work) {
+            try {
+                node.work();
+            } catch (...) {
+                Fail(std::current_exception());
+            }
+        }
+
+        // release ready successors; keep the last one to run inline
+        NodeId next = m_Nodes.size();
+        for (NodeId successor : node.successors) {
+            if (m_Nodes[successor].remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                continue;
+            if (next != m_Nodes.size())
+                Schedule(next);
+            next = successor;
+        }
+
+        if (m_Unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // last node: the graph may be reused as soon as m_Running drops
+            auto error = std::exchange(m_Error, nullptr);
+            auto done = std::move(m_Done);
+            m_Running.store(false, std::memory_order_release);
+            if (error)
+                done.set_exception(error);
+            else
+                done.set_value();
+            return;
+        }
+        if (next == m_Nodes.size())
+            return;
+        id = next;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <vector>
+
+class ThreadPool;
+
+// A reusable DAG of tasks. Build it once (add nodes, add edges), then run it
+// on a ThreadPool as often as needed with ThreadPool::run(graph).
+//
+// Every node keeps an atomic count of unfinished predecessors. The worker
+// that finishes a node decrements the counts of its successors and schedules
+// those that reach zero itself, keeping one of them to run inline, so no
+// worker ever blocks waiting on another node. A failing node stops the rest
+// of the graph from doing work; the run's future then carries the exception.
+// If the pool refuses a post (e.g. it is shutting down), the run fails the
+// same way and the refused nodes are walked without running their work, so
+// the future always becomes ready.
+class TaskGraph
+{
+  public:
+    using NodeId = size_t;
+
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    NodeId add(std::function<void()> work);
+
+    // `before` must complete before `after` starts
+    void precede(NodeId before, NodeId after);
+
+    size_t size() const noexcept { return m_Nodes.size(); }
+    bool running() const noexcept { return m_Running.load(std::memory_order_acquire); }
+
+  private:
+    friend class ThreadPool;
+
+    struct Node {
+        std::function<void()> work;
+        std::vector<NodeId> successors;
+        size_t dependencies = 0;
+        std::atomic<size_t> remaining{0};
+    };
+
+    std::future<void> Start(ThreadPool &pool, size_t lane);
+    void Execute(NodeId id);
+    void Schedule(NodeId id);
+    void Fail(std::exception_ptr error);
+    void Validate();
+
+    std::deque<Node> m_Nodes;
+    std::vector<NodeId> m_Roots;
+    bool m_Validated = false;
+
+    // state of the current run
+    std::atomic<bool> m_Running{false};
+    std::atomic<size_t> m_Unfinished{0};
+    std::atomic<bool> m_Failed{false};
+    std::exception_ptr m_Error;
+    std::promise<void> m_Done;
+    ThreadPool *m_Pool = nullptr;
+    size_t m_Lane = 0;
+};
@@ -1,38 +1,507 @@
 #include "threadpool.h"
 
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
 #include <thread>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 ThreadPool::ThreadPool(size_t numberOfWorker)
-    : m_Stop(false)
+    : ThreadPool([numberOfWorker] {
+          Options options;
+          options.numberOfWorker = numberOfWorker;
+          return options;
+      }())
+{
+}
+
+namespace
 {
-    for (int i = 0; i < numberOfWorker; ++i) {
-        m_Workers.emplace_back([this] { this->WorkerFunc(); });
+thread_local ThreadPool *t_CurrentPool = nullptr;
+}
+
+thread_local ThreadPool::WorkerTelemetry *ThreadPool::t_Telemetry = nullptr;
+
+ThreadPool::ThreadPool(const Options &options)
+    : m_TelemetryEnabled(options.telemetry), m_OnTelemetry(options.onTelemetry),
+      m_TelemetryInterval(options.telemetryInterval), m_Lanes(options.numberOfLanes),
+      m_DefaultLane(options.defaultLane),
+      m_AgingQuota(options.agingQuota), m_Pending(0), m_OnIdle(options.onIdle),
+      m_IdlePollInterval(options.idlePollInterval),
+      m_MaxIdlePollInterval(std::max(options.idlePollInterval, options.maxIdlePollInterval)),
+      m_CpuSet(options.cpuSet),
+      m_PinOnePerCpu(options.pinOnePerCpu),
+      m_MinWorkers(options.minWorkers ? options.minWorkers : options.numberOfWorker),
+      m_MaxWorkers(options.maxWorkers ? options.maxWorkers : options.numberOfWorker),
+      m_IdleTimeout(options.idleTimeout), m_MonitorInterval(options.monitorInterval),
+      m_MaxQueueWait(options.maxQueueWait), m_Spawned(0), m_Live(0), m_Idle(0),
+      m_Blocked(0), m_Parked(0), m_Spin(options.spin), m_Stop(false)
+{
+    if (options.numberOfWorker == 0)
+        throw std::invalid_argument("ThreadPool needs at least one worker");
+    if (options.numberOfLanes == 0 || options.defaultLane >= options.numberOfLanes)
+        throw std::invalid_argument("Invalid ThreadPool lane configuration");
+    if (m_MinWorkers > options.numberOfWorker || options.numberOfWorker > m_MaxWorkers)
+        throw std::invalid_argument("ThreadPool needs minWorkers <= numberOfWorker <= maxWorkers");
+    for (int cpu : m_CpuSet) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE)
+            throw std::invalid_argument("CPU index out of range");
+    }
+
+    m_Timers = std::make_unique<TimerWheel>(*this, options.timerTick, options.timerSlots);
+
+    try {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (size_t i = 0; i < options.numberOfWorker; ++i) {
+            Spawn();
+            int rc = Pin(m_Workers.back(), i);
+            if (rc != 0)
+                throw std::system_error(rc, std::generic_category(),
+                                        "pthread_setaffinity_np");
+        }
+        if (m_MaxWorkers > m_MinWorkers || m_OnTelemetry)
+            m_Monitor = std::thread([this] { this->MonitorFunc(); });
+    } catch (...) {
+        Shutdown();
+        throw;
     }
 }
 
-ThreadPool::~ThreadPool()
+ThreadPool::~ThreadPool() { Shutdown(); }
+
+void ThreadPool::Shutdown()
 {
-    unique_lock<mutex> lock(mtx);
-    stop = true;
+    // pending timers are dropped; the ones already due are queued below
+    if (m_Timers)
+        m_Timers->stop();
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Stop = true;
     lock.unlock();
-    cv.notify_all();
+    m_Cv.notify_all();
+    m_MonitorCv.notify_all();
+
+    if (m_Monitor.joinable())
+        m_Monitor.join();
+
+    // wait for queued tasks to complete; no worker can be spawned any more
+    lock.lock();
+    auto workers = std::move(m_Workers);
+    m_Workers.clear();
+    m_Retired.clear();
+    lock.unlock();
+    for (auto &thread : workers)
+        thread.join();
+}
+
+ThreadPool *ThreadPool::current() noexcept { return t_CurrentPool; }
+
+// Start one more worker, m_Mutex must be held
+void ThreadPool::Spawn()
+{
+    WorkerTelemetry *telemetry = nullptr;
+    if (m_TelemetryEnabled) {
+        m_Telemetry.push_back(std::make_unique<WorkerTelemetry>());
+        telemetry = m_Telemetry.back().get();
+    }
+    try {
+        m_Workers.emplace_back([this, telemetry] { this->WorkerFunc(telemetry); });
+    } catch (...) {
+        if (telemetry)
+            m_Telemetry.pop_back();
+        throw;
+    }
+    ++m_Live;
+    ++m_Spawned;
+}
+
+// Join workers that retired, m_Mutex must be held (it is released meanwhile)
+void ThreadPool::Reap(std::unique_lock<std::mutex> &lock)
+{
+    if (m_Retired.empty())
+        return;
 
-    // wait for tasks to complete
-    for (const auto &thread : m_Futures)
+    std::vector<std::thread> retired;
+    for (auto id : m_Retired) {
+        auto it = std::find_if(m_Workers.begin(), m_Workers.end(),
+                               [id](const std::thread &t) { return t.get_id() == id; });
+        if (it != m_Workers.end()) {
+            retired.push_back(std::move(*it));
+            m_Workers.erase(it);
+        }
+    }
+    m_Retired.clear();
+
+    lock.unlock();
+    for (auto &thread : retired)
         thread.join();
+    lock.lock();
+}
+
+int ThreadPool::Pin(std::thread &worker, size_t index)
+{
+    if (m_CpuSet.empty())
+        return 0;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (m_PinOnePerCpu) {
+        CPU_SET(m_CpuSet[index % m_CpuSet.size()], &set);
+    } else {
+        for (int cpu : m_CpuSet)
+            CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(worker.native_handle(), sizeof(set), &set);
+#else
+    (void)worker;
+    (void)index;
+    return 0;
+#endif
+}
+
+// Grow the pool while every worker is busy and work keeps piling up, and
+// hand out telemetry snapshots
+void ThreadPool::MonitorFunc()
+{
+    bool elastic = m_MaxWorkers > m_MinWorkers;
+    auto interval = m_TelemetryInterval;
+    if (elastic)
+        interval = m_OnTelemetry ? std::min(m_MonitorInterval, m_TelemetryInterval)
+                                 : m_MonitorInterval;
+    auto nextDump = Clock::now() + m_TelemetryInterval;
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (!m_Stop) {
+        m_MonitorCv.wait_for(lock, interval, [this] { return m_Stop; });
+        if (m_Stop)
+            break;
+
+        // workers inside a blocking_section are not going to take work soon
+        size_t running = m_Live - m_Blocked;
+        bool saturated = m_Pending > 0 && m_Idle == 0 && m_Live < m_MaxWorkers;
+        if (saturated && (m_Pending > running || OldestWait() > m_MaxQueueWait)) {
+            Spawn();
+            // best effort: an unpinned worker is better than no worker
+            Pin(m_Workers.back(), m_Spawned - 1);
+        }
+        Reap(lock);
+
+        if (m_OnTelemetry && Clock::now() >= nextDump) {
+            nextDump += m_TelemetryInterval;
+            lock.unlock();
+            m_OnTelemetry(telemetry());
+            lock.lock();
+        }
+    }
 }
 
-void ThreadPool::WorkerFunc()
+// Queue wait of the oldest queued task, m_Mutex must be held
+ThreadPool::Clock::duration ThreadPool::OldestWait() const
 {
-    std::function<void()> task;
+    auto oldest = Clock::time_point::max();
+    for (const auto &lane : m_Lanes) {
+        if (!lane.fifo.empty())
+            oldest = std::min(oldest, lane.fifo.front().enqueued);
+        for (const auto &task : lane.edf)
+            oldest = std::min(oldest, task.enqueued);
+    }
+    return oldest == Clock::time_point::max() ? Clock::duration::zero()
+                                              : Clock::now() - oldest;
+}
+
+blocking_section::blocking_section() : m_Pool(ThreadPool::current())
+{
+    if (!m_Pool)
+        return;
+    std::lock_guard<std::mutex> lock(m_Pool->m_Mutex);
+    ++m_Pool->m_Blocked;
+    // hand our slot over to a fresh worker if nobody else can take the work
+    if (!m_Pool->m_Stop && m_Pool->m_Idle == 0 && m_Pool->m_Live < m_Pool->m_MaxWorkers) {
+        m_Pool->Spawn();
+        m_Pool->Pin(m_Pool->m_Workers.back(), m_Pool->m_Spawned - 1);
+    }
+}
+
+blocking_section::~blocking_section()
+{
+    if (!m_Pool)
+        return;
+    std::lock_guard<std::mutex> lock(m_Pool->m_Mutex);
+    --m_Pool->m_Blocked;
+}
+
+const LatencyHistogram &ThreadPool::queue_wait(size_t lane) const
+{
+    if (lane >= m_Lanes.size())
+        throw std::out_of_range("ThreadPool lane out of range");
+    return m_Lanes[lane].queueWait;
+}
+
+void ThreadPool::push(size_t lane, Task task)
+{
+    if (lane >= m_Lanes.size())
+        throw std::out_of_range("ThreadPool lane out of range");
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        // once stopping, only our own workers may add (follow-up) work
+        if (m_Stop && t_CurrentPool != this)
+            throw std::runtime_error("ThreadPool is stopped");
+
+        Lane &target = m_Lanes[lane];
+        if (task.deadline == Clock::time_point::max()) {
+            target.fifo.push(std::move(task));
+        } else {
+            target.edf.push_back(std::move(task));
+            std::push_heap(target.edf.begin(), target.edf.end(), LaterDeadline{});
+        }
+        ++m_Pending;
+        // spinning workers see m_Pending by themselves, skip the futex call
+        wake = m_Parked > 0;
+    }
+    if (wake)
+        m_Cv.notify_one();
+}
+
+void ThreadPool::push_bulk(size_t lane, Queue<Task> tasks)
+{
+    if (lane >= m_Lanes.size())
+        throw std::out_of_range("ThreadPool lane out of range");
+    size_t count = tasks.size();
+    size_t wake = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Stop && t_CurrentPool != this)
+            throw std::runtime_error("ThreadPool is stopped");
+
+        m_Lanes[lane].fifo.splice(tasks);
+        m_Pending += count;
+        wake = std::min(count, m_Parked);
+    }
+    for (size_t i = 0; i < wake; ++i)
+        m_Cv.notify_one();
+}
+
+// Pick the next task, m_Mutex must be held. Lanes are served in strict
+// priority order, except that a lane passed over m_AgingQuota times wins.
+// `now` is the caller's latest clock reading, it dates the queue wait.
+bool ThreadPool::pop(Task &task, Clock::time_point now)
+{
+    if (m_Pending == 0)
+        return false;
+
+    size_t chosen = m_Lanes.size();
+    size_t starved = m_Lanes.size();
+    for (size_t i = 0; i < m_Lanes.size(); ++i) {
+        if (m_Lanes[i].empty())
+            continue;
+        if (chosen == m_Lanes.size())
+            chosen = i;
+        else if (starved == m_Lanes.size() && m_Lanes[i].skipped >= m_AgingQuota)
+            starved = i;
+    }
+    if (starved != m_Lanes.size())
+        chosen = starved;
+
+    for (size_t i = 0; i < m_Lanes.size(); ++i) {
+        if (i != chosen && !m_Lanes[i].empty())
+            ++m_Lanes[i].skipped;
+    }
+
+    Lane &lane = m_Lanes[chosen];
+    lane.skipped = 0;
+    if (!lane.edf.empty()) {
+        std::pop_heap(lane.edf.begin(), lane.edf.end(), LaterDeadline{});
+        task = std::move(lane.edf.back());
+        lane.edf.pop_back();
+    } else {
+        task = std::move(lane.fifo.front());
+        lane.fifo.pop();
+    }
+    --m_Pending;
+
+    // m_Mutex serialises the writers of the lane histograms. `now` may
+    // predate a task pushed while we waited for the lock.
+    auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(now - task.enqueued);
+    lane.queueWait.record_exclusive(waited.count() > 0 ? uint64_t(waited.count()) : 0);
+    return true;
+}
+
+bool ThreadPool::try_run_one()
+{
+    Task task;
+    auto started = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!pop(task, started))
+            return false;
+    }
+    task.fn();
+    // a worker helping out (e.g. in parallel_for) accounts the task as its own
+    if (t_CurrentPool == this && t_Telemetry)
+        t_Telemetry->ran(Clock::now() - started);
+    return true;
+}
+
+void ThreadPool::WorkerFunc(WorkerTelemetry *telemetry)
+{
+    t_CurrentPool = this;
+    t_Telemetry = telemetry;
+    Task task;
+    // one clock reading per task: the end of a task is the start of the next
+    auto now = Clock::now();
+    std::unique_lock<std::mutex> lock(m_Mutex);
     while (true) {
-        unique_lock<mutex> lock(mtx);
-        cv.wait(lock, [this] { return !m_Tasks.empty() || stop; });
-        if (stop)
-            return;
-        task = move(m_Tasks.front());
-        m_Tasks.pop();
+        if (pop(task, now)) {
+            lock.unlock();
+            auto started = now;
+            task.fn();
+            task.fn = nullptr;
+            now = Clock::now();
+            if (telemetry)
+                telemetry->ran(now - started);
+            lock.lock();
+            continue;
+        }
+        // drain what is left before honouring the stop request
+        if (m_Stop)
+            break;
+        if (!WaitForWork(lock, telemetry)) {
+            m_Retired.push_back(std::this_thread::get_id());
+            RetireTelemetry();
+            break;
+        }
+        now = Clock::now();
+    }
+    --m_Live;
+}
+
+// Fold the counters of the calling (retiring) worker into m_RetiredStats,
+// m_Mutex must be held
+void ThreadPool::RetireTelemetry()
+{
+    auto it = std::find_if(m_Telemetry.begin(), m_Telemetry.end(),
+                           [](const auto &t) { return t.get() == t_Telemetry; });
+    if (it == m_Telemetry.end())
+        return;
+    WorkerStats stats = (*it)->stats();
+    m_RetiredStats.tasks += stats.tasks;
+    m_RetiredStats.steals += stats.steals;
+    m_RetiredStats.busy += stats.busy;
+    m_RetiredStats.idle += stats.idle;
+    m_RetiredRunTime.add((*it)->runTime);
+    m_Telemetry.erase(it);
+    t_Telemetry = nullptr;
+}
+
+void ThreadPool::WorkerTelemetry::ran(Clock::duration elapsed) noexcept
+{
+    auto ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    bump(tasks, 1);
+    bump(busyNs, ns);
+    runTime.record_exclusive(ns);
+}
+
+void ThreadPool::WorkerTelemetry::waited(Clock::duration elapsed, bool stole) noexcept
+{
+    bump(idleNs, uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    if (stole)
+        bump(steals, 1);
+}
+
+ThreadPool::WorkerStats ThreadPool::WorkerTelemetry::stats() const noexcept
+{
+    WorkerStats stats;
+    stats.tasks = tasks.load(std::memory_order_relaxed);
+    stats.steals = steals.load(std::memory_order_relaxed);
+    stats.busy = std::chrono::nanoseconds(busyNs.load(std::memory_order_relaxed));
+    stats.idle = std::chrono::nanoseconds(idleNs.load(std::memory_order_relaxed));
+    return stats;
+}
+
+ThreadPool::TelemetrySnapshot ThreadPool::telemetry() const
+{
+    TelemetrySnapshot snapshot;
+    snapshot.taken = Clock::now();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    snapshot.retired = m_RetiredStats;
+    snapshot.runTime = m_RetiredRunTime;
+    snapshot.workers.reserve(m_Telemetry.size());
+    for (const auto &worker : m_Telemetry) {
+        snapshot.workers.push_back(worker->stats());
+        snapshot.runTime.add(worker->runTime);
+    }
+    for (const auto &lane : m_Lanes)
+        snapshot.queueWait.push_back(lane.queueWait);
+    return snapshot;
+}
+
+// Park until there is work, m_Mutex must be held. Returns false when the
+// worker has been idle for m_IdleTimeout and the pool may shrink.
+bool ThreadPool::WaitForWork(std::unique_lock<std::mutex> &lock, WorkerTelemetry *telemetry)
+{
+    auto ready = [this] { return m_Pending > 0 || m_Stop; };
+    bool elastic = m_Live > m_MinWorkers;
+    auto idleSince = Clock::now();
+    auto waitStart = idleSince;
+    auto poll = m_IdlePollInterval;
+    bool found = false;
+
+    ++m_Idle;
+    if (!ready() && (m_Spin.spins || m_Spin.yields)) {
         lock.unlock();
-        task();
+        spin_until(m_Spin, [this] { return m_Pending.load(std::memory_order_acquire) > 0; });
+        lock.lock();
+    }
+
+    while (!ready()) {
+        if (m_Live > m_MinWorkers && Clock::now() - idleSince >= m_IdleTimeout) {
+            --m_Idle;
+            if (telemetry)
+                telemetry->waited(Clock::now() - waitStart, false);
+            return false;
+        }
+
+        if (!found) {
+            ++m_Parked;
+            if (m_OnIdle)
+                m_Cv.wait_for(lock, poll, ready);
+            else if (elastic)
+                m_Cv.wait_until(lock, idleSince + m_IdleTimeout, ready);
+            else
+                m_Cv.wait(lock, ready);
+            --m_Parked;
+            if (ready())
+                break;
+        }
+
+        if (m_OnIdle) {
+            // look for foreign work only after our own lanes stayed empty,
+            // and keep at it without sleeping while it keeps turning up
+            --m_Idle;
+            lock.unlock();
+            found = m_OnIdle();
+            lock.lock();
+            ++m_Idle;
+            // back off while there is nothing to steal, so an idle system
+            // does not keep every worker waking up
+            poll = found ? m_IdlePollInterval : std::min(poll * 2, m_MaxIdlePollInterval);
+            if (found) {
+                idleSince = Clock::now();
+                if (telemetry) {
+                    telemetry->waited(idleSince - waitStart, true);
+                    waitStart = idleSince;
+                }
+            }
+        }
+        elastic = m_Live > m_MinWorkers;
     }
+    --m_Idle;
+    if (telemetry)
+        telemetry->waited(Clock::now() - waitStart, false);
+    return true;
 }
@@ -1,22 +1,384 @@
 #pragma once
-#include "../data-structure/queue-safe.h"
+#include "../stl/data-structure/Queue.h"
+#include "../stl/data-structure/SpinWait.h"
+#include "latency_histogram.h"
+#include "task_graph.h"
+#include "timer_wheel.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
 class ThreadPool
 {
   public:
+    using Clock = std::chrono::steady_clock;
+
+    // Names of the lanes of a pool built with the default three lanes.
+    // Lane 0 is always the most urgent one.
+    enum Priority : size_t { High = 0, Normal = 1, Low = 2 };
+
+    struct WorkerStats {
+        uint64_t tasks = 0;
+        // tasks found through onIdle, e.g. stolen from another pool
+        uint64_t steals = 0;
+        Clock::duration busy{};
+        // waiting for work, including spinning and running onIdle
+        Clock::duration idle{};
+
+        double utilization() const noexcept
+        {
+            auto total = busy + idle;
+            return total.count() ? double(busy.count()) / double(total.count()) : 0.0;
+        }
+    };
+
+    struct TelemetrySnapshot {
+        Clock::time_point taken;
+        // one entry per live worker
+        std::vector<WorkerStats> workers;
+        // everything the workers that retired so far had counted
+        WorkerStats retired;
+        // indexed by lane
+        std::vector<LatencyHistogram> queueWait;
+        LatencyHistogram runTime;
+
+        WorkerStats total() const noexcept
+        {
+            WorkerStats sum = retired;
+            for (const auto &worker : workers) {
+                sum.tasks += worker.tasks;
+                sum.steals += worker.steals;
+                sum.busy += worker.busy;
+                sum.idle += worker.idle;
+            }
+            return sum;
+        }
+    };
+
+    struct Options {
+        size_t numberOfWorker = std::thread::hardware_concurrency();
+        size_t numberOfLanes = 3;
+        size_t defaultLane = Normal;
+        // A waiting lane that has been passed over this many times is served
+        // next, even if a more urgent lane still has work (anti-starvation).
+        size_t agingQuota = 32;
+        // CPUs the workers may run on (empty: no pinning). With pinOnePerCpu
+        // worker i is pinned to cpuSet[i % size], otherwise to the whole set.
+        std::vector<int> cpuSet;
+        bool pinOnePerCpu = false;
+        // Called by a worker that found its own lanes empty; returns true if it
+        // found work elsewhere. Polled every idlePollInterval while idle; the
+        // interval doubles after each fruitless call up to
+        // maxIdlePollInterval, and starts over once work turns up.
+        std::function<bool()> onIdle;
+        std::chrono::microseconds idlePollInterval{500};
+        std::chrono::microseconds maxIdlePollInterval{20000};
+        // Elastic sizing: the pool grows up to maxWorkers while every worker
+        // is busy and the backlog or the oldest queue wait keeps growing, and
+        // idle workers above minWorkers retire after idleTimeout. 0 means
+        // numberOfWorker, i.e. a fixed-size pool.
+        size_t minWorkers = 0;
+        size_t maxWorkers = 0;
+        std::chrono::milliseconds idleTimeout{5000};
+        std::chrono::milliseconds monitorInterval{10};
+        std::chrono::microseconds maxQueueWait{1000};
+        // How long an idle worker spins and yields before parking on the
+        // condition variable
+        SpinPolicy spin;
+        // Per-worker counters and run-time histograms. onTelemetry, if set,
+        // gets a snapshot every telemetryInterval from the monitor thread.
+        bool telemetry = true;
+        std::function<void(const TelemetrySnapshot &)> onTelemetry;
+        std::chrono::milliseconds telemetryInterval{1000};
+        // Resolution and size of the timer wheel behind schedule_after and
+        // schedule_every. Timers further out than timerSlots ticks just take
+        // more laps.
+        std::chrono::microseconds timerTick{1000};
+        size_t timerSlots = 4096;
+    };
+
     explicit ThreadPool(size_t numberOfWorker);
 
+    explicit ThreadPool(const Options &options);
+
     ~ThreadPool();
 
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Run f on the default lane
+    template <typename F> auto submit(F &&f)
+    {
+        return submit(m_DefaultLane, std::forward<F>(f));
+    }
+
+    // Run f on the given lane, in FIFO order with the lane's other plain tasks
+    template <typename F> auto submit(size_t lane, F &&f)
+    {
+        return enqueue(lane, Clock::time_point::max(), std::forward<F>(f));
+    }
+
+    // Run f on the given lane, earliest deadline first. Tasks with a deadline
+    // are served before the plain FIFO tasks of the same lane.
+    template <typename F> auto submit(size_t lane, Clock::time_point deadline, F &&f)
+    {
+        return enqueue(lane, deadline, std::forward<F>(f));
+    }
+
+    // Run every callable of the range on the default lane. The whole batch
+    // is queued under one lock acquisition and wakes at most one parked
+    // worker per task.
+    template <std::ranges::input_range Range> auto submit_bulk(Range &&fns)
+    {
+        return submit_bulk(m_DefaultLane, std::forward<Range>(fns));
+    }
+
+    template <std::ranges::input_range Range> auto submit_bulk(size_t lane, Range &&fns)
+    {
+        using F = std::decay_t<std::ranges::range_reference_t<Range>>;
+        using Result = std::invoke_result_t<F>;
+        std::vector<std::future<Result>> futures;
+        Queue<Task> tasks;
+        auto now = Clock::now();
+        for (auto &&f : fns) {
+            auto task = std::make_shared<std::packaged_task<Result()>>(
+                std::forward<decltype(f)>(f));
+            futures.push_back(task->get_future());
+            tasks.push(Task{[task] { (*task)(); }, now, Clock::time_point::max()});
+        }
+        push_bulk(lane, std::move(tasks));
+        return futures;
+    }
+
+    // Fire-and-forget: no future and no shared state. f must not throw.
+    template <typename F> void post(F &&f) { post(m_DefaultLane, std::forward<F>(f)); }
+
+    template <typename F> void post(size_t lane, F &&f)
+    {
+        push(lane, Task{std::forward<F>(f), Clock::now(), Clock::time_point::max()});
+    }
+
+    // Post f to the default lane after delay, without occupying a worker
+    // meanwhile. Like post(), f must not throw.
+    template <typename F> TimerId schedule_after(Clock::duration delay, F &&f)
+    {
+        return schedule_after(m_DefaultLane, delay, std::forward<F>(f));
+    }
+
+    template <typename F> TimerId schedule_after(size_t lane, Clock::duration delay, F &&f)
+    {
+        return m_Timers->add(lane, delay, Clock::duration::zero(), std::forward<F>(f));
+    }
+
+    // Post f every period, the first time one period from now. A firing that
+    // takes longer than the period overlaps with the next one.
+    template <typename F> TimerId schedule_every(Clock::duration period, F &&f)
+    {
+        return schedule_every(m_DefaultLane, period, std::forward<F>(f));
+    }
+
+    template <typename F> TimerId schedule_every(size_t lane, Clock::duration period, F &&f)
+    {
+        if (period <= Clock::duration::zero())
+            throw std::invalid_argument("schedule_every needs a positive period");
+        return m_Timers->add(lane, period, period, std::forward<F>(f));
+    }
+
+    // Stop a timer; false if it already fired (one-shot), was cancelled, or
+    // was never scheduled because the pool is shutting down (!id.valid())
+    bool cancel(TimerId id) { return m_Timers->cancel(id); }
+
+    // Number of timers waiting to fire
+    size_t timers() const { return m_Timers->size(); }
+
+    // Run every node of the graph, respecting its edges. The future becomes
+    // ready once all nodes have finished; the graph can then be run again.
+    std::future<void> run(TaskGraph &graph) { return run(graph, m_DefaultLane); }
+    std::future<void> run(TaskGraph &graph, size_t lane) { return graph.Start(*this, lane); }
+
+#if defined(__cpp_impl_coroutine)
+    // co_await pool.schedule() suspends the coroutine and resumes it on a
+    // worker. See coro_task.h for the task type and combinators.
+    struct ScheduleAwaiter {
+        ThreadPool &pool;
+        size_t lane;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            pool.post(lane, [handle] { handle.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+
+    ScheduleAwaiter schedule() { return {*this, m_DefaultLane}; }
+    ScheduleAwaiter schedule(size_t lane) { return {*this, lane}; }
+#endif
+
+    // Run one queued task on the calling thread, if there is one
+    bool try_run_one();
+
+    // Pool whose worker is running the calling thread, nullptr elsewhere
+    static ThreadPool *current() noexcept;
+
+    // Number of live workers, lock-free like pending()
+    size_t size() const noexcept { return m_Live.load(std::memory_order_relaxed); }
+    size_t lanes() const noexcept { return m_Lanes.size(); }
+    // True once the pool is shutting down; push() from outside its workers
+    // throws from then on
+    bool stopped() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Stop;
+    }
+    // Number of queued tasks; lock-free, so it may be stale by the time it is used
+    size_t pending() const noexcept { return m_Pending.load(std::memory_order_relaxed); }
+
+    // Time spent by tasks of a lane between submission and start of execution
+    const LatencyHistogram &queue_wait(size_t lane) const;
+
+    // Aggregate the per-worker telemetry. Counters are read while the workers
+    // keep updating them, so the snapshot is consistent per counter only.
+    TelemetrySnapshot telemetry() const;
+
   private:
-    void WorkerFunc();
+    struct Task {
+        std::function<void()> fn;
+        Clock::time_point enqueued;
+        Clock::time_point deadline;
+    };
+
+    // Min-heap order on deadline for the EDF part of a lane
+    struct LaterDeadline {
+        bool operator()(const Task &a, const Task &b) const
+        {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    struct Lane {
+        Queue<Task> fifo;
+        std::vector<Task> edf;
+        size_t skipped = 0;
+        LatencyHistogram queueWait;
+
+        bool empty() const noexcept { return fifo.empty() && edf.empty(); }
+    };
+
+    // Counters of one worker. Only the owning worker writes them, so plain
+    // load/store pairs are enough; the atomics just make snapshots race-free.
+    struct alignas(64) WorkerTelemetry {
+        std::atomic<uint64_t> tasks{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> busyNs{0};
+        std::atomic<uint64_t> idleNs{0};
+        LatencyHistogram runTime;
+
+        static void bump(std::atomic<uint64_t> &counter, uint64_t n) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + n,
+                          std::memory_order_relaxed);
+        }
+
+        void ran(Clock::duration elapsed) noexcept;
+        void waited(Clock::duration elapsed, bool stole) noexcept;
+        WorkerStats stats() const noexcept;
+    };
+
+    template <typename F> auto enqueue(size_t lane, Clock::time_point deadline, F &&f)
+    {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        auto future = task->get_future();
+        push(lane, Task{[task] { (*task)(); }, Clock::now(), deadline});
+        return future;
+    }
+
+    void push(size_t lane, Task task);
+    void push_bulk(size_t lane, Queue<Task> tasks);
+    bool pop(Task &task, Clock::time_point now);
+
+    void WorkerFunc(WorkerTelemetry *telemetry);
+    bool WaitForWork(std::unique_lock<std::mutex> &lock, WorkerTelemetry *telemetry);
+    void MonitorFunc();
+    void Spawn();
+    void Reap(std::unique_lock<std::mutex> &lock);
+    Clock::duration OldestWait() const;
+    int Pin(std::thread &worker, size_t index);
+    void Shutdown();
+    void RetireTelemetry();
+
+    // counters of the worker running the calling thread
+    static thread_local WorkerTelemetry *t_Telemetry;
+
+    friend class blocking_section;
 
   private:
     std::vector<std::thread> m_Workers;
-    QueueSafe<std::function<void()>> m_Tasks;
+    std::vector<std::thread::id> m_Retired;
+    // live workers' counters plus the sum of those that retired
+    std::vector<std::unique_ptr<WorkerTelemetry>> m_Telemetry;
+    WorkerStats m_RetiredStats;
+    LatencyHistogram m_RetiredRunTime;
+    bool m_TelemetryEnabled;
+    std::function<void(const TelemetrySnapshot &)> m_OnTelemetry;
+    std::chrono::milliseconds m_TelemetryInterval;
+    std::unique_ptr<TimerWheel> m_Timers;
+    std::thread m_Monitor;
+    std::condition_variable m_MonitorCv;
+    std::vector<Lane> m_Lanes;
+    size_t m_DefaultLane;
+    size_t m_AgingQuota;
+    std::atomic<size_t> m_Pending;
+    std::function<bool()> m_OnIdle;
+    std::chrono::microseconds m_IdlePollInterval;
+    std::chrono::microseconds m_MaxIdlePollInterval;
+    std::vector<int> m_CpuSet;
+    bool m_PinOnePerCpu;
+    size_t m_MinWorkers;
+    size_t m_MaxWorkers;
+    std::chrono::milliseconds m_IdleTimeout;
+    std::chrono::milliseconds m_MonitorInterval;
+    std::chrono::microseconds m_MaxQueueWait;
+    size_t m_Spawned;
+    std::atomic<size_t> m_Live;
+    size_t m_Idle;
+    size_t m_Blocked;
+    size_t m_Parked;
+    SpinPolicy m_Spin;
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_Cv;
     bool m_Stop;
-};
\ No newline at end of file
+};
+
+// Declares that the current pool task is about to block (I/O, a lock, a
+// future). While the section is alive the pool treats the worker as lost and
+// spawns a compensating worker if no other one is idle, up to maxWorkers.
+// Outside a pool worker it does nothing.
+class blocking_section
+{
+  public:
+    blocking_section();
+    ~blocking_section();
+
+    blocking_section(const blocking_section &) = delete;
+    blocking_section &operator=(const blocking_section &) = delete;
+
+  private:
+    ThreadPool *m_Pool;
+};
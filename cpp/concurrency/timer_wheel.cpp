@@ -0,0 +1,223 @@
+#include "timer_wheel.h"
+
+#include "threadpool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+TimerWheel::TimerWheel(ThreadPool &pool, Clock::duration tick, size_t slots)
+    : m_Pool(pool), m_Tick(tick), m_Epoch(Clock::now()), m_Current(0), m_Wake(UINT64_MAX), m_Slots(slots, None),
+      m_Free(None), m_Size(0), m_Stop(false)
+{
+    if (tick <= Clock::duration::zero() || slots == 0)
+        throw std::invalid_argument("TimerWheel needs a positive tick and at least one slot");
+}
+
+TimerWheel::~TimerWheel() { stop(); }
+
+void TimerWheel::stop()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+    lock.unlock();
+    m_Cv.notify_all();
+    if (m_Thread.joinable())
+        m_Thread.join();
+
+    lock.lock();
+    m_Nodes.clear();
+    m_Slots.assign(m_Slots.size(), None);
+    m_Free = None;
+    m_Size = 0;
+}
+
+// Whole ticks between the epoch and `when`
+uint64_t TimerWheel::TicksUntil(Clock::time_point when) const
+{
+    if (when <= m_Epoch)
+        return 0;
+    return uint64_t((when - m_Epoch) / m_Tick);
+}
+
+// First tick after m_Current whose slot is not empty, m_Mutex must be held
+// and a timer pending. Its timers may be laps away, in which case the
+// thread just wakes up once more for nothing.
+uint64_t TimerWheel::NextTick() const
+{
+    uint64_t tick = m_Current + 1;
+    while (m_Slots[tick % m_Slots.size()] == None)
+        ++tick;
+    return tick;
+}
+
+TimerId TimerWheel::add(size_t lane, Clock::duration delay, Clock::duration period,
+                        std::function<void()> fn)
+{
+    if (lane >= m_Pool.lanes())
+        throw std::out_of_range("ThreadPool lane out of range");
+
+    auto now = Clock::now();
+    auto when = now + std::max(delay, Clock::duration::zero());
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    // timers added while the pool shuts down never fire; say so with an
+    // invalid handle
+    if (m_Stop)
+        return TimerId{};
+    // an empty wheel does not tick; skip the ticks it slept through
+    if (m_Size == 0)
+        m_Current = std::max(m_Current, TicksUntil(now));
+
+    uint32_t index = m_Free;
+    if (index == None) {
+        if (m_Nodes.size() >= None)
+            throw std::length_error("Too many pending timers");
+        m_Nodes.emplace_back();
+        index = uint32_t(m_Nodes.size() - 1);
+    } else {
+        m_Free = m_Nodes[index].next;
+    }
+
+    Node &node = m_Nodes[index];
+    node.fn = std::move(fn);
+    // round up, so a timer never fires early
+    uint64_t due = TicksUntil(when);
+    if (m_Epoch + m_Tick * due < when)
+        ++due;
+    node.due = std::max(due, m_Current + 1);
+    node.period = 0;
+    if (period > Clock::duration::zero()) {
+        auto ticks = uint64_t((period + m_Tick - Clock::duration(1)) / m_Tick);
+        node.period = std::max<uint64_t>(1, ticks);
+    }
+    node.lane = lane;
+    node.pending = true;
+    Link(index);
+    TimerId id{index, node.generation};
+
+    // wake the thread if it sleeps past this timer, or for nothing at all
+    bool sooner = node.due < m_Wake;
+    if (sooner)
+        m_Wake = node.due;
+    if (m_Size++ == 0 && !m_Thread.joinable())
+        m_Thread = std::thread([this] { ThreadFunc(); });
+    if (sooner) {
+        lock.unlock();
+        m_Cv.notify_one();
+    }
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (id.index >= m_Nodes.size())
+        return false;
+    Node &node = m_Nodes[id.index];
+    if (!node.pending || node.generation != id.generation)
+        return false;
+    Unlink(id.index);
+    Release(id.index);
+    return true;
+}
+
+size_t TimerWheel::size() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Size;
+}
+
+// Push a node to the front of its slot list, m_Mutex must be held
+void TimerWheel::Link(uint32_t index)
+{
+    Node &node = m_Nodes[index];
+    uint32_t &head = m_Slots[node.due % m_Slots.size()];
+    node.prev = None;
+    node.next = head;
+    if (head != None)
+        m_Nodes[head].prev = index;
+    head = index;
+}
+
+void TimerWheel::Unlink(uint32_t index)
+{
+    Node &node = m_Nodes[index];
+    if (node.prev != None)
+        m_Nodes[node.prev].next = node.next;
+    else
+        m_Slots[node.due % m_Slots.size()] = node.next;
+    if (node.next != None)
+        m_Nodes[node.next].prev = node.prev;
+}
+
+// Return an unlinked node to the free list; stale TimerIds stop matching
+void TimerWheel::Release(uint32_t index)
+{
+    Node &node = m_Nodes[index];
+    node.fn = nullptr;
+    node.pending = false;
+    ++node.generation;
+    node.next = m_Free;
+    m_Free = index;
+    --m_Size;
+}
+
+// Collect the timers of the slot of `tick` that are due, m_Mutex must be held.
+// Nodes of later laps stay where they are.
+void TimerWheel::Expire(uint64_t tick,
+                        std::vector<std::pair<size_t, std::function<void()>>> &due)
+{
+    uint32_t index = m_Slots[tick % m_Slots.size()];
+    while (index != None) {
+        Node &node = m_Nodes[index];
+        uint32_t next = node.next;
+        if (node.due <= tick) {
+            Unlink(index);
+            if (node.period) {
+                due.emplace_back(node.lane, node.fn);
+                // relinked at the head, behind our cursor even for the same slot
+                node.due = std::max(node.due + node.period, tick + 1);
+                Link(index);
+            } else {
+                due.emplace_back(node.lane, std::move(node.fn));
+                Release(index);
+            }
+        }
+        index = next;
+    }
+}
+
+void TimerWheel::ThreadFunc()
+{
+    std::vector<std::pair<size_t, std::function<void()>>> due;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (!m_Stop) {
+        if (m_Size == 0) {
+            m_Wake = UINT64_MAX;
+            m_Cv.wait(lock, [this] { return m_Stop || m_Size > 0; });
+            continue;
+        }
+
+        uint64_t wake = m_Wake = NextTick();
+        m_Cv.wait_until(lock, m_Epoch + m_Tick * wake,
+                        [this, wake] { return m_Stop || m_Wake != wake; });
+        if (m_Stop)
+            break;
+
+        // the slots before m_Wake are empty, so skip straight to it, then
+        // catch up with every tick that passed since, e.g. after a slow post
+        uint64_t now = TicksUntil(Clock::now());
+        m_Current = std::max(m_Current, std::min(now, m_Wake - 1));
+        while (m_Current < now && m_Size > 0)
+            Expire(++m_Current, due);
+        m_Current = std::max(m_Current, now);
+
+        if (!due.empty()) {
+            lock.unlock();
+            for (auto &[lane, fn] : due)
+                m_Pool.post(lane, std::move(fn));
+            due.clear();
+            lock.lock();
+        }
+    }
+}
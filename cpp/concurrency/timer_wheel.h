@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool;
+
+// Handle of a timer scheduled on a ThreadPool, used to cancel it. A
+// default-constructed one refers to no timer; cancel() returns false for it.
+struct TimerId {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const noexcept { return index != UINT32_MAX; }
+};
+
+// Hashed timing wheel behind ThreadPool::schedule_after/schedule_every.
+//
+// Time is cut into ticks; a timer due at tick T sits in slot T % slots with
+// the number of full laps it still has to wait. One timer thread advances
+// the wheel and posts what is due to the pool, so no worker ever sleeps for
+// a timer. It sleeps until the next tick whose slot holds a timer rather
+// than waking every tick, and add() wakes it early for a sooner timer. Timers live in a slab of nodes linked into their
+// slot by index, which makes adding and cancelling O(1) and keeps a million
+// pending timers in a few contiguous blocks instead of a heap of callbacks.
+// The thread only starts with the first timer.
+class TimerWheel
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    TimerWheel(ThreadPool &pool, Clock::duration tick, size_t slots);
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    // Run fn on `lane` after `delay`, then every `period` unless it is zero.
+    // Firings are rounded up to the next tick. After stop(), e.g. from a task
+    // that re-arms itself while the pool shuts down, the timer is dropped and
+    // the returned TimerId is not valid(); this does not throw, so such tasks
+    // do not fail during shutdown.
+    TimerId add(size_t lane, Clock::duration delay, Clock::duration period,
+                std::function<void()> fn);
+
+    // True if the timer was still pending. A periodic timer may have one
+    // firing already handed to the pool.
+    bool cancel(TimerId id);
+
+    // Number of pending timers
+    size_t size() const;
+
+    // Drop all pending timers and join the timer thread
+    void stop();
+
+  private:
+    static constexpr uint32_t None = UINT32_MAX;
+
+    struct Node {
+        std::function<void()> fn;
+        uint64_t due = 0;
+        uint64_t period = 0; // in ticks, 0 for one-shot timers
+        size_t lane = 0;
+        uint32_t prev = None;
+        uint32_t next = None;
+        uint32_t generation = 0;
+        bool pending = false;
+    };
+
+    uint64_t TicksUntil(Clock::time_point when) const;
+    uint64_t NextTick() const;
+    void Link(uint32_t index);
+    void Unlink(uint32_t index);
+    void Release(uint32_t index);
+    void ThreadFunc();
+    void Expire(uint64_t tick, std::vector<std::pair<size_t, std::function<void()>>> &due);
+
+    ThreadPool &m_Pool;
+    Clock::duration m_Tick;
+    Clock::time_point m_Epoch;
+    // last tick whose slot has been expired
+    uint64_t m_Current;
+    // tick the timer thread sleeps until; the slots before it are empty
+    uint64_t m_Wake;
+    // heads of the per-slot lists
+    std::vector<uint32_t> m_Slots;
+    // slab of timer nodes; the free ones are chained through `next`
+    std::deque<Node> m_Nodes;
+    uint32_t m_Free;
+    size_t m_Size;
+
+    std::thread m_Thread;
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_Cv;
+    bool m_Stop;
+};
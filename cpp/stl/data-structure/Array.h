@@ -1,63 +1,69 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <stdexcept>
 
-template <typename Type, size_t N> struct Array {
-    ~Array() = default;
-    // Default constructor (zero-initialized if applicable)
-    Array() = default;
-    // Value-initialized constructor
-    explicit Array(Type default_value)
-    {
-        std::fill(std::begin(m_data), std::end(m_data), default_value);
-    }
-    // Copy constructor
-    Array(const Array &other)
-    {
-        std::copy(std::begin(other.m_data), std::end(other.m_data),
-                  std::begin(m_data));
-    }
-    // Copy assignment
-    Array &operator=(const Array &other)
-    {
-        if (this != &other) {
-            std::copy(std::begin(other.m_data), std::end(other.m_data),
-                      std::begin(m_data));
-        }
-        return *this;
-    }
-    // Move constructor
-    Array(Array &&other) noexcept
-    {
-        std::move(std::begin(other.m_data), std::end(other.m_data),
-                  std::begin(m_data));
-    }
-    // Move assignment
-    Array &operator=(Array &&other)
-    {
-        if (this != &other) {
-            std::move(std::begin(other.m_data), std::end(other.m_data),
-                      std::begin(m_data));
-        }
-        return *this;
-    }
+// Fixed-size array. It is an aggregate, so Array<int, 3> a{1, 2, 3} works and
+// copies are trivial when Type's are (memcpy, no hand-written loops). Like a
+// built-in array, Array<int, 3> a; leaves the elements uninitialized, so
+// default construction costs nothing; write Array<int, 3> a{} for zeros.
+// operator[] is unchecked so loops over it vectorize; at() checks the index
+// and throws. Everything is constexpr, so lookup tables can be built at
+// compile time:
+//
+//   constexpr auto squares = [] {
+//       Array<int, 16> t;
+//       for (size_t i = 0; i < t.size(); ++i)
+//           t[i] = int(i * i);
+//       return t;
+//   }();
+//
+// Align raises the alignment of the storage, e.g. to 64 for SIMD loads.
+template <typename Type, size_t N, size_t Align = alignof(Type)> struct Array {
+    static_assert(N > 0, "Array needs at least one element");
+    static_assert(Align >= alignof(Type) && (Align & (Align - 1)) == 0,
+                  "Align must be a power of two no smaller than alignof(Type)");
+
+    // Unchecked element access
+    constexpr Type &operator[](size_t index) noexcept { return m_data[index]; }
+    constexpr const Type &operator[](size_t index) const noexcept { return m_data[index]; }
 
-    Type &operator[](size_t index)
+    // Checked element access
+    constexpr Type &at(size_t index)
     {
         if (index >= N)
             throw std::out_of_range("Index out of range");
         return m_data[index];
     }
-    const Type &operator[](size_t index) const
+    constexpr const Type &at(size_t index) const
     {
         if (index >= N)
             throw std::out_of_range("Index out of range");
         return m_data[index];
     }
 
+    constexpr void fill(const Type &value) { std::fill(begin(), end(), value); }
+
+    // Array with every element set to value
+    static constexpr Array filled(const Type &value)
+    {
+        Array array;
+        array.fill(value);
+        return array;
+    }
+
     // Size accessor
-    constexpr size_t size() const noexcept { return N; }
+    static constexpr size_t size() noexcept { return N; }
+
+    constexpr Type *data() noexcept { return m_data; }
+    constexpr const Type *data() const noexcept { return m_data; }
+
+    constexpr Type *begin() noexcept { return m_data; }
+    constexpr const Type *begin() const noexcept { return m_data; }
+    constexpr Type *end() noexcept { return m_data + N; }
+    constexpr const Type *end() const noexcept { return m_data + N; }
 
-  private:
-    Type m_data[N];
+    // Public so the type stays an aggregate
+    alignas(Align) Type m_data[N];
 };
@@ -1,15 +1,23 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <memory>
+#include <span>
 #include <stdexcept>
+#include <utility>
 
-struct CircularBuffer {
+// Fixed-capacity ring that overwrites its oldest element when full. The
+// capacity is rounded up to a power of two so positions wrap with a mask.
+// The stored elements form at most two contiguous runs, which peek_spans()
+// exposes without copying (e.g. for writev or SIMD kernels).
+template <typename T = int> struct CircularBuffer {
     CircularBuffer() = default;
     explicit CircularBuffer(size_t capacity)
-        : m_buffer(std::make_unique<int[]>(capacity)), m_capacity(capacity),
-          m_size(0), m_head(0), m_tail(0)
+        : m_capacity(capacity ? std::bit_ceil(capacity) : 0),
+          m_buffer(m_capacity ? std::make_unique<T[]>(m_capacity) : nullptr),
+          m_mask(m_capacity - 1), m_size(0), m_head(0)
     {
         if (capacity == 0) {
             std::__throw_invalid_argument("Capacity must be > 0");
@@ -22,10 +30,9 @@ struct CircularBuffer {
 
     // Deep copy
     CircularBuffer(const CircularBuffer &other)
-        : m_buffer(other.m_capacity ? std::make_unique<int[]>(other.m_capacity)
-                                    : nullptr),
-          m_capacity(other.m_capacity), m_size(other.m_size), m_head(other.m_head),
-          m_tail(other.m_tail)
+        : m_capacity(other.m_capacity),
+          m_buffer(other.m_capacity ? std::make_unique<T[]>(other.m_capacity) : nullptr),
+          m_mask(other.m_mask), m_size(other.m_size), m_head(other.m_head)
     {
         std::copy(other.m_buffer.get(), other.m_buffer.get() + other.m_capacity,
                   m_buffer.get());
@@ -35,15 +42,15 @@ struct CircularBuffer {
     {
         if (this != &other) {
             auto new_buff = other.m_capacity
-                                ? std::make_unique<int[]>(other.m_capacity)
+                                ? std::make_unique<T[]>(other.m_capacity)
                                 : nullptr;
             std::copy(other.m_buffer.get(), other.m_buffer.get() + other.m_capacity,
                       new_buff.get());
 
             m_capacity = other.m_capacity;
+            m_mask = other.m_mask;
             m_size = other.m_size;
             m_head = other.m_head;
-            m_tail = other.m_tail;
             m_buffer = std::move(new_buff);
         }
         return *this;
@@ -55,41 +62,101 @@ struct CircularBuffer {
     bool isEmpty() const { return m_size == 0; }
     bool isFull() const { return m_size == m_capacity; }
 
-    // Push
-    void enqueue(int val)
-    {
-        if (isFull()) {
-            m_head = (++m_head) % m_capacity;
-        } else {
-            ++m_size;
-        }
+    // Oldest and newest element, the buffer must not be empty
+    const T &front() const { return m_buffer[m_head]; }
+    const T &back() const { return m_buffer[(m_head + m_size - 1) & m_mask]; }
 
-        m_buffer[m_tail] = val;
-        m_tail = (++m_tail) % m_capacity;
-        ;
-    }
+    // Push; overwrites the oldest element when full
+    void enqueue(const T &val) { store(val); }
+    void enqueue(T &&val) { store(std::move(val)); }
 
     // dequeue
-    int dequeue()
+    T dequeue()
     {
         if (isEmpty()) {
             std::__throw_out_of_range("Queue is empty.");
         }
 
-        int res = m_buffer[m_head];
+        T res = std::move(m_buffer[m_head]);
 
-        m_head = (m_head + 1) % m_capacity;
+        m_head = (m_head + 1) & m_mask;
         --m_size;
 
         return res;
     }
 
+    // Push all items with at most two block copies. Like enqueue, the oldest
+    // elements are overwritten when they do not fit.
+    void enqueue_bulk(std::span<const T> items)
+    {
+        if (items.size() >= m_capacity) {
+            // only the newest `capacity` items survive
+            items = items.last(m_capacity);
+            std::copy(items.begin(), items.end(), m_buffer.get());
+            m_head = 0;
+            m_size = m_capacity;
+            return;
+        }
+
+        size_t tail = (m_head + m_size) & m_mask;
+        size_t first = std::min(items.size(), m_capacity - tail);
+        std::copy(items.begin(), items.begin() + first, m_buffer.get() + tail);
+        std::copy(items.begin() + first, items.end(), m_buffer.get());
+
+        size_t overflow = m_size + items.size() > m_capacity
+                              ? m_size + items.size() - m_capacity
+                              : 0;
+        m_head = (m_head + overflow) & m_mask;
+        m_size += items.size() - overflow;
+    }
+
+    // Move up to out.size() of the oldest elements into out, returns how many
+    size_t dequeue_bulk(std::span<T> out)
+    {
+        auto [first, second] = peek_spans();
+        size_t count = std::min(out.size(), m_size);
+        size_t fromFirst = std::min(count, first.size());
+        std::move(first.begin(), first.begin() + fromFirst, out.begin());
+        std::move(second.begin(), second.begin() + (count - fromFirst),
+                  out.begin() + fromFirst);
+        consume(count);
+        return count;
+    }
+
+    // The stored elements, oldest first, as up to two contiguous runs (the
+    // second one is empty unless the elements wrap around the end)
+    std::pair<std::span<const T>, std::span<const T>> peek_spans() const
+    {
+        const T *data = m_buffer.get();
+        size_t first = std::min(m_size, m_capacity - m_head);
+        return {std::span<const T>(data + m_head, first),
+                std::span<const T>(data, m_size - first)};
+    }
+
+    // Drop the `count` oldest elements, e.g. after processing peek_spans()
+    void consume(size_t count)
+    {
+        if (count > m_size) {
+            std::__throw_out_of_range("Not enough elements to consume.");
+        }
+        m_head = (m_head + count) & m_mask;
+        m_size -= count;
+    }
+
   private:
-    std::unique_ptr<int[]> m_buffer;
+    template <typename U> void store(U &&val)
+    {
+        m_buffer[(m_head + m_size) & m_mask] = std::forward<U>(val);
+        if (isFull()) {
+            m_head = (m_head + 1) & m_mask;
+        } else {
+            ++m_size;
+        }
+    }
+
     size_t m_capacity{0};
+    std::unique_ptr<T[]> m_buffer;
+    size_t m_mask{0};
     size_t m_size{0};
     size_t m_head{0}; // index of oldest element
-    size_t m_tail{0}; // index where next enqueue writes
-
-    void swap() {}
 };
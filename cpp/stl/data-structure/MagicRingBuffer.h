@@ -0,0 +1,172 @@
+#pragma once
+
+// Linux only: needs memfd_create and mmap
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+// Byte ring whose storage is mapped twice back to back in virtual memory, so
+// byte capacity() + i aliases byte i. Every readable or writable region is
+// then one contiguous range, even across the wrap: parsers read straight out
+// of read_region() and read()/recv() write straight into write_region(),
+// with no scratch copies (unlike CircularBuffer, whose data may come as two
+// spans).
+//
+// The capacity is rounded up to a power of two of at least one page. Head
+// and tail only ever grow and are masked on access. Single-threaded, like
+// CircularBuffer.
+class MagicRingBuffer
+{
+  public:
+    explicit MagicRingBuffer(size_t capacity)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("Capacity must be > 0");
+        }
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        m_capacity = std::bit_ceil(std::max(capacity, page));
+
+        int fd = memfd_create("MagicRingBuffer", MFD_CLOEXEC);
+        if (fd < 0) {
+            throw_errno("memfd_create");
+        }
+        if (ftruncate(fd, static_cast<off_t>(m_capacity)) != 0) {
+            int err = errno;
+            close(fd);
+            throw_errno("ftruncate", err);
+        }
+
+        // reserve both halves, then map the file over each of them
+        void *base = mmap(nullptr, 2 * m_capacity, PROT_NONE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            int err = errno;
+            close(fd);
+            throw_errno("mmap", err);
+        }
+        m_data = static_cast<std::byte *>(base);
+
+        for (size_t half = 0; half < 2; ++half) {
+            void *view = mmap(m_data + half * m_capacity, m_capacity,
+                              PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+            if (view == MAP_FAILED) {
+                int err = errno;
+                munmap(m_data, 2 * m_capacity);
+                close(fd);
+                throw_errno("mmap", err);
+            }
+        }
+        // the mappings keep the memory alive
+        close(fd);
+    }
+
+    ~MagicRingBuffer()
+    {
+        if (m_data) {
+            munmap(m_data, 2 * m_capacity);
+        }
+    }
+
+    MagicRingBuffer(const MagicRingBuffer &) = delete;
+    MagicRingBuffer &operator=(const MagicRingBuffer &) = delete;
+
+    MagicRingBuffer(MagicRingBuffer &&other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+          m_capacity(std::exchange(other.m_capacity, 0)),
+          m_head(std::exchange(other.m_head, 0)),
+          m_tail(std::exchange(other.m_tail, 0))
+    {
+    }
+
+    MagicRingBuffer &operator=(MagicRingBuffer &&other) noexcept
+    {
+        if (this != &other) {
+            if (m_data) {
+                munmap(m_data, 2 * m_capacity);
+            }
+            m_data = std::exchange(other.m_data, nullptr);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_head = std::exchange(other.m_head, 0);
+            m_tail = std::exchange(other.m_tail, 0);
+        }
+        return *this;
+    }
+
+    size_t size() const { return m_tail - m_head; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_tail == m_head; }
+    bool full() const { return size() == m_capacity; }
+
+    // All stored bytes, oldest first, as one contiguous range
+    std::span<const std::byte> read_region() const
+    {
+        return {m_data + (m_head & (m_capacity - 1)), size()};
+    }
+
+    // All free space as one contiguous range; fill it, then commit()
+    std::span<std::byte> write_region()
+    {
+        return {m_data + (m_tail & (m_capacity - 1)), m_capacity - size()};
+    }
+
+    // Mark `count` bytes of write_region() as written
+    void commit(size_t count)
+    {
+        if (count > m_capacity - size()) {
+            throw std::out_of_range("Commit exceeds free space.");
+        }
+        m_tail += count;
+    }
+
+    // Drop the `count` oldest bytes, e.g. after parsing read_region()
+    void consume(size_t count)
+    {
+        if (count > size()) {
+            throw std::out_of_range("Not enough bytes to consume.");
+        }
+        m_head += count;
+        if (m_head == m_tail) {
+            m_head = m_tail = 0;
+        }
+    }
+
+    // Copy as many bytes as fit, returns how many
+    size_t write(std::span<const std::byte> bytes)
+    {
+        auto region = write_region();
+        size_t count = std::min(bytes.size(), region.size());
+        std::memcpy(region.data(), bytes.data(), count);
+        m_tail += count;
+        return count;
+    }
+
+    // Copy up to out.size() of the oldest bytes into out, returns how many
+    size_t read(std::span<std::byte> out)
+    {
+        auto region = read_region();
+        size_t count = std::min(out.size(), region.size());
+        std::memcpy(out.data(), region.data(), count);
+        consume(count);
+        return count;
+    }
+
+  private:
+    [[noreturn]] static void throw_errno(const char *what, int err = errno)
+    {
+        throw std::system_error(err, std::generic_category(), what);
+    }
+
+    std::byte *m_data = nullptr; // 2 * m_capacity bytes of address space
+    size_t m_capacity = 0;
+    size_t m_head = 0;
+    size_t m_tail = 0;
+};
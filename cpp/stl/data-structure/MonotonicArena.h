@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+
+// Bump-pointer memory resource for allocations that all die together, e.g.
+// everything one request builds. allocate() rounds the current position up
+// to the alignment and advances it; deallocate() does nothing. reset()
+// releases everything at once but, unlike
+// std::pmr::monotonic_buffer_resource::release(), keeps the chunks for the
+// next round, so a steady stream of similar requests stops calling upstream.
+//
+// Chunks come from `upstream`; each new one is twice the size of the last
+// (or as large as an oversized request). Not thread-safe.
+class MonotonicArena : public std::pmr::memory_resource
+{
+  public:
+    explicit MonotonicArena(size_t chunk_size = 64 * 1024,
+                            std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+        : m_chunk_size(chunk_size), m_upstream(upstream)
+    {
+        if (chunk_size == 0) {
+            throw std::invalid_argument("Chunk size must be > 0");
+        }
+    }
+
+    ~MonotonicArena() override
+    {
+        while (m_first) {
+            Chunk *chunk = m_first;
+            m_first = chunk->next;
+            m_upstream->deallocate(chunk, sizeof(Chunk) + chunk->size, alignof(Chunk));
+        }
+    }
+
+    MonotonicArena(const MonotonicArena &) = delete;
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+    // Free every allocation at once; the chunks are kept
+    void reset() noexcept
+    {
+        m_current = m_first;
+        if (m_current) {
+            m_position = m_current->data();
+            m_end = m_position + m_current->size;
+        }
+        m_used = 0;
+    }
+
+    // Bytes handed out since the last reset (including alignment padding)
+    size_t used() const noexcept { return m_used; }
+
+    // Bytes held from upstream
+    size_t reserved() const noexcept
+    {
+        size_t total = 0;
+        for (Chunk *chunk = m_first; chunk; chunk = chunk->next) {
+            total += chunk->size;
+        }
+        return total;
+    }
+
+  private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk *next;
+        size_t size; // usable bytes after the header
+
+        std::byte *data() noexcept { return reinterpret_cast<std::byte *>(this + 1); }
+    };
+
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        std::byte *start = align_up(m_position, alignment);
+        if (!m_position || start + bytes > m_end) {
+            next_chunk(bytes + alignment);
+            start = align_up(m_position, alignment);
+        }
+        m_used += (start - m_position) + bytes;
+        m_position = start + bytes;
+        return start;
+    }
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    static std::byte *align_up(std::byte *p, size_t alignment) noexcept
+    {
+        auto value = reinterpret_cast<uintptr_t>(p);
+        return p + ((alignment - value % alignment) % alignment);
+    }
+
+    // Move to a chunk with at least `needed` bytes: the next kept one if it
+    // is large enough, otherwise a new one linked in after the current one
+    void next_chunk(size_t needed)
+    {
+        Chunk *next = m_current ? m_current->next : m_first;
+        if (!next || next->size < needed) {
+            size_t size = std::max(needed, m_current ? m_current->size * 2 : m_chunk_size);
+            auto *chunk = static_cast<Chunk *>(
+                m_upstream->allocate(sizeof(Chunk) + size, alignof(Chunk)));
+            chunk->size = size;
+            chunk->next = next;
+            if (m_current) {
+                m_current->next = chunk;
+            } else {
+                m_first = chunk;
+            }
+            next = chunk;
+        }
+        m_current = next;
+        m_position = next->data();
+        m_end = m_position + next->size;
+    }
+
+    size_t m_chunk_size;
+    std::pmr::memory_resource *m_upstream;
+    Chunk *m_first = nullptr;
+    Chunk *m_current = nullptr;
+    std::byte *m_position = nullptr;
+    std::byte *m_end = nullptr;
+    size_t m_used = 0;
+};
@@ -1,18 +1,38 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <initializer_list>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
 #include <utility>
 
+// FIFO queue stored as a singly linked list of fixed-size blocks (about
+// 512 bytes, at most 64 elements each). Elements of a block live in
+// [begin, end); push appends to the tail block, pop advances the head
+// block's begin. A block emptied by pop is kept as a spare for the next
+// push, so a queue that stays roughly the same size never touches the
+// allocator.
+//
+// Blocks come from the global heap, or from a std::pmr::memory_resource
+// passed to the constructor. As with Vector, copies get the global heap
+// unless one is given and moves take the resource along; splicing or
+// move-assigning between queues with different resources moves the elements
+// instead of relinking blocks.
 template <typename T> class Queue
 {
   public:
     // Default constructor
     Queue() = default;
 
+    // Empty queue allocating from resource (nullptr for the global heap)
+    explicit Queue(std::pmr::memory_resource *resource) noexcept : m_resource(resource) {}
+
     // Initializer list constructor
-    Queue(std::initializer_list<T> init)
+    Queue(std::initializer_list<T> init, std::pmr::memory_resource *resource = nullptr)
+        : m_resource(resource)
     {
         for (const auto &item : init) {
             push(item);
@@ -20,12 +40,14 @@ template <typename T> class Queue
     }
 
     // Copy constructor
-    Queue(const Queue &other)
+    Queue(const Queue &other, std::pmr::memory_resource *resource = nullptr)
+        : m_resource(resource)
     {
         try {
             copy_from(other);
         } catch (...) {
             clear();
+            release(m_spare);
             throw;
         }
     }
@@ -34,7 +56,7 @@ template <typename T> class Queue
     Queue &operator=(const Queue &other)
     {
         if (this != &other) {
-            Queue temp(other); // Copy-and-swap idiom
+            Queue temp(other, m_resource); // Copy-and-swap idiom
             swap(temp);
         }
         return *this;
@@ -44,24 +66,36 @@ template <typename T> class Queue
     Queue(Queue &&other) noexcept
         : m_head(std::exchange(other.m_head, nullptr)),
           m_tail(std::exchange(other.m_tail, nullptr)),
-          m_size(std::exchange(other.m_size, 0))
+          m_spare(std::exchange(other.m_spare, nullptr)),
+          m_size(std::exchange(other.m_size, 0)), m_resource(other.m_resource)
     {
     }
 
-    // Move assignment operator
-    Queue &operator=(Queue &&other) noexcept
+    // Move assignment operator; only allocates if the resources differ
+    Queue &operator=(Queue &&other)
     {
-        if (this != &other) {
-            clear();
-            m_head = std::exchange(other.m_head, nullptr);
-            m_tail = std::exchange(other.m_tail, nullptr);
-            m_size = std::exchange(other.m_size, 0);
+        if (this == &other) {
+            return *this;
         }
+        clear();
+        if (m_resource != other.m_resource) {
+            splice(other);
+            return *this;
+        }
+        release(m_spare);
+        m_head = std::exchange(other.m_head, nullptr);
+        m_tail = std::exchange(other.m_tail, nullptr);
+        m_spare = std::exchange(other.m_spare, nullptr);
+        m_size = std::exchange(other.m_size, 0);
         return *this;
     }
 
     // Destructor
-    ~Queue() { clear(); }
+    ~Queue()
+    {
+        clear();
+        release(m_spare);
+    }
 
     // Element access
     T &front()
@@ -69,7 +103,7 @@ template <typename T> class Queue
         if (empty()) {
             throw std::runtime_error("Queue is empty");
         }
-        return m_head->value;
+        return *m_head->at(m_head->begin);
     }
 
     const T &front() const
@@ -77,7 +111,7 @@ template <typename T> class Queue
         if (empty()) {
             throw std::runtime_error("Queue is empty");
         }
-        return m_head->value;
+        return *m_head->at(m_head->begin);
     }
 
     T &back()
@@ -85,7 +119,7 @@ template <typename T> class Queue
         if (empty()) {
             throw std::runtime_error("Queue is empty");
         }
-        return m_tail->value;
+        return *m_tail->at(m_tail->end - 1);
     }
 
     const T &back() const
@@ -93,7 +127,7 @@ template <typename T> class Queue
         if (empty()) {
             throw std::runtime_error("Queue is empty");
         }
-        return m_tail->value;
+        return *m_tail->at(m_tail->end - 1);
     }
 
     // Capacity
@@ -108,14 +142,26 @@ template <typename T> class Queue
 
     template <typename... Args> void emplace(Args &&...args)
     {
-        auto new_node = std::make_unique<Node>(std::forward<Args>(args)...);
-
-        if (empty()) {
-            m_head = std::move(new_node);
-            m_tail = m_head.get();
+        if (m_tail && m_tail->end < block_size) {
+            std::construct_at(m_tail->at(m_tail->end), std::forward<Args>(args)...);
+            ++m_tail->end;
         } else {
-            m_tail->next = std::move(new_node);
-            m_tail = m_tail->next.get();
+            // fill the new block before linking it, so a throwing
+            // constructor leaves the queue untouched
+            Block *block = acquire();
+            try {
+                std::construct_at(block->at(0), std::forward<Args>(args)...);
+            } catch (...) {
+                recycle(block);
+                throw;
+            }
+            block->end = 1;
+            if (m_tail) {
+                m_tail->next = block;
+            } else {
+                m_head = block;
+            }
+            m_tail = block;
         }
         ++m_size;
     }
@@ -126,31 +172,130 @@ template <typename T> class Queue
             throw std::runtime_error("Queue is empty");
         }
 
-        m_head = std::move(m_head->next);
+        std::destroy_at(m_head->at(m_head->begin));
+        ++m_head->begin;
         --m_size;
 
-        if (!m_head) {
-            m_tail = nullptr;
+        if (m_head->begin == m_head->end) {
+            if (m_head == m_tail) {
+                // reuse the only block from its start
+                m_head->begin = m_head->end = 0;
+            } else {
+                recycle(std::exchange(m_head, m_head->next));
+            }
+        }
+    }
+
+    // Move all elements of other to the back of this queue, in O(1). The
+    // unused end of our last block is skipped, not filled. If the queues use
+    // different resources the elements are moved one by one instead.
+    void splice(Queue &other)
+    {
+        if (other.empty() || this == &other) {
+            return;
+        }
+        if (m_resource != other.m_resource) {
+            for (Block *block = other.m_head; block; block = block->next) {
+                for (std::size_t i = block->begin; i < block->end; ++i) {
+                    push(std::move(*block->at(i)));
+                }
+            }
+            other.clear();
+            return;
         }
+
+        if (empty()) {
+            clear();
+            m_head = std::exchange(other.m_head, nullptr);
+        } else {
+            m_tail->next = std::exchange(other.m_head, nullptr);
+        }
+        m_tail = std::exchange(other.m_tail, nullptr);
+        m_size += std::exchange(other.m_size, 0);
+    }
+
+    // Detach the first min(count, size()) elements into a new queue. Whole
+    // blocks are relinked; only the block the cut falls into has its first
+    // part moved into a new block.
+    Queue split_front(std::size_t count)
+    {
+        Queue front(m_resource);
+        if (count == 0 || empty()) {
+            return front;
+        }
+        if (count >= m_size) {
+            std::swap(m_head, front.m_head);
+            std::swap(m_tail, front.m_tail);
+            std::swap(m_size, front.m_size);
+            return front;
+        }
+
+        Block *prev = nullptr;
+        Block *cut = m_head;
+        std::size_t taken = 0;
+        while (taken + (cut->end - cut->begin) <= count) {
+            taken += cut->end - cut->begin;
+            prev = cut;
+            cut = cut->next;
+        }
+
+        Block *last = prev;
+        if (taken < count) {
+            std::size_t part = count - taken;
+            last = acquire();
+            std::size_t moved = 0;
+            try {
+                for (; moved < part; ++moved) {
+                    std::construct_at(last->at(moved),
+                                      std::move(*cut->at(cut->begin + moved)));
+                }
+            } catch (...) {
+                std::destroy(last->at(0), last->at(moved));
+                recycle(last);
+                throw;
+            }
+            std::destroy(cut->at(cut->begin), cut->at(cut->begin + part));
+            cut->begin += part;
+            last->end = part;
+            if (prev) {
+                prev->next = last;
+            }
+        }
+
+        front.m_head = prev ? m_head : last;
+        front.m_tail = last;
+        last->next = nullptr;
+        front.m_size = count;
+        m_head = cut;
+        m_size -= count;
+        return front;
     }
 
     void clear() noexcept
     {
-        while (!empty()) {
-            m_head = std::move(m_head->next);
-            --m_size;
+        while (m_head) {
+            Block *block = std::exchange(m_head, m_head->next);
+            std::destroy(block->at(block->begin), block->at(block->end));
+            recycle(block);
         }
         m_tail = nullptr;
+        m_size = 0;
     }
 
+    // Both queues should use the same resource; it is swapped as well
     void swap(Queue &other) noexcept
     {
         using std::swap;
         swap(m_head, other.m_head);
         swap(m_tail, other.m_tail);
+        swap(m_spare, other.m_spare);
         swap(m_size, other.m_size);
+        swap(m_resource, other.m_resource);
     }
 
+    // The memory resource, nullptr for the global heap
+    std::pmr::memory_resource *resource() const noexcept { return m_resource; }
+
     // Comparison operators
     bool operator==(const Queue &other) const
     {
@@ -158,15 +303,29 @@ template <typename T> class Queue
             return false;
         }
 
-        auto current1 = m_head.get();
-        auto current2 = other.m_head.get();
-
-        while (current1 && current2) {
-            if (current1->value != current2->value) {
-                return false;
+        // walk both queues block by block
+        const Block *block1 = m_head;
+        const Block *block2 = other.m_head;
+        std::size_t i1 = block1 ? block1->begin : 0;
+        std::size_t i2 = block2 ? block2->begin : 0;
+        for (std::size_t left = m_size; left > 0;) {
+            if (i1 == block1->end) {
+                block1 = block1->next;
+                i1 = block1->begin;
             }
-            current1 = current1->next.get();
-            current2 = current2->next.get();
+            if (i2 == block2->end) {
+                block2 = block2->next;
+                i2 = block2->begin;
+            }
+            std::size_t run = std::min({block1->end - i1, block2->end - i2, left});
+            for (std::size_t k = 0; k < run; ++k) {
+                if (*block1->at(i1 + k) != *block2->at(i2 + k)) {
+                    return false;
+                }
+            }
+            i1 += run;
+            i2 += run;
+            left -= run;
         }
 
         return true;
@@ -175,33 +334,79 @@ template <typename T> class Queue
     bool operator!=(const Queue &other) const { return !(*this == other); }
 
   private:
-    struct Node {
-        T value;
-        std::unique_ptr<Node> next;
+    static constexpr std::size_t block_size =
+        std::clamp<std::size_t>(512 / sizeof(T), 4, 64);
 
-        template <typename... Args>
-        explicit Node(Args &&...args)
-            : value(std::forward<Args>(args)...), next(nullptr)
+    struct Block {
+        Block *next = nullptr;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        alignas(T) unsigned char storage[block_size * sizeof(T)];
+
+        T *at(std::size_t i) noexcept
         {
+            return std::launder(reinterpret_cast<T *>(storage)) + i;
+        }
+        const T *at(std::size_t i) const noexcept
+        {
+            return std::launder(reinterpret_cast<const T *>(storage)) + i;
         }
     };
 
+    Block *acquire()
+    {
+        Block *block = std::exchange(m_spare, nullptr);
+        if (block) {
+            return block;
+        }
+        // default-initialize: the header gets its member initializers, the
+        // element storage stays raw instead of being zeroed on every block
+        if (m_resource) {
+            return ::new (m_resource->allocate(sizeof(Block), alignof(Block))) Block;
+        }
+        return new Block;
+    }
+
+    // Keep one empty block for the next push, free the rest
+    void recycle(Block *block) noexcept
+    {
+        block->next = nullptr;
+        block->begin = block->end = 0;
+        if (!m_spare) {
+            m_spare = block;
+        } else {
+            release(block);
+        }
+    }
+
+    void release(Block *&block) noexcept
+    {
+        Block *old = std::exchange(block, nullptr);
+        if (old && m_resource) {
+            m_resource->deallocate(old, sizeof(Block), alignof(Block));
+        } else {
+            delete old;
+        }
+    }
+
     void copy_from(const Queue &other)
     {
-        auto current = other.m_head.get();
-        while (current) {
-            push(current->value);
-            current = current->next.get();
+        for (const Block *block = other.m_head; block; block = block->next) {
+            for (std::size_t i = block->begin; i < block->end; ++i) {
+                push(*block->at(i));
+            }
         }
     }
 
-    std::unique_ptr<Node> m_head{nullptr};
-    Node *m_tail{nullptr};
+    Block *m_head{nullptr};
+    Block *m_tail{nullptr};
+    Block *m_spare{nullptr}; // one-block cache
     std::size_t m_size{0};
+    std::pmr::memory_resource *m_resource{nullptr}; // nullptr: global heap
 };
 
 // Non-member swap
 template <typename T> void swap(Queue<T> &lhs, Queue<T> &rhs) noexcept
 {
     lhs.swap(rhs);
-}
\ No newline at end of file
+}
@@ -1,38 +1,325 @@
 #pragma once
 
 #include "Queue.h"
+#include "SpinWait.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+
+// Thrown by push() on a closed queue and by pop() on a closed, drained one
+class QueueClosed : public std::runtime_error
+{
+  public:
+    QueueClosed() : std::runtime_error("QueueSafe is closed") {}
+};
+
+// Thrown by push() on a full queue with OverflowPolicy::Fail
+class QueueFull : public std::runtime_error
+{
+  public:
+    QueueFull() : std::runtime_error("QueueSafe is full") {}
+};
+
+// What push() does when a bounded queue is full
+enum class OverflowPolicy {
+    Block,      // wait until a consumer made room
+    DropNewest, // discard the element being pushed
+    DropOldest, // discard the front element to make room
+    Fail        // throw QueueFull
+};
 
 template <typename T> class QueueSafe
 {
   public:
-    // Push new element into the queue using perfect forwarding
-    template <typename U> void push(U &&val)
+    static constexpr size_t Unbounded = SIZE_MAX;
+
+    QueueSafe() = default;
+
+    // Consumers spin and yield within `spin` before they block in pop()
+    explicit QueueSafe(SpinPolicy spin) : m_spin(spin) {}
+
+    // Bounded queue: at most `capacity` elements, `policy` decides what
+    // happens to pushes beyond that
+    explicit QueueSafe(size_t capacity, OverflowPolicy policy = OverflowPolicy::Block,
+                       SpinPolicy spin = SpinPolicy::none())
+        : m_capacity(capacity), m_policy(policy), m_spin(spin)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("QueueSafe capacity must be positive");
+    }
+
+    // Push new element into the queue using perfect forwarding. Returns
+    // false if the element was dropped (OverflowPolicy::DropNewest).
+    template <typename U> bool push(U &&val)
     {
+        bool wake;
         {
             // Lock the mutex for thread-safe access
-            std::lock_guard<std::mutex> guard(m_mutex);
+            std::unique_lock<std::mutex> guard(m_mutex);
+            if (m_closed)
+                throw QueueClosed();
+            if (m_buffer.size() >= m_capacity) {
+                switch (m_policy) {
+                case OverflowPolicy::Block:
+                    wait_not_full(guard);
+                    break;
+                case OverflowPolicy::DropNewest:
+                    ++m_dropped;
+                    return false;
+                case OverflowPolicy::DropOldest:
+                    drop_front(1);
+                    break;
+                case OverflowPolicy::Fail:
+                    throw QueueFull();
+                }
+            }
             m_buffer.push(std::forward<U>(val)); // Use perfect forwarding
+            m_count.fetch_add(1, std::memory_order_release);
+            wake = m_waiters > 0; // Spinning consumers need no wake-up
+        }
+        if (wake)
+            m_not_empty.notify_one(); // Notify waiting threads after the lock is released
+        return true;
+    }
+
+    // Append a pre-built chain of elements under a single lock acquisition
+    // and wake at most as many blocked consumers as there are new elements.
+    // On a bounded queue the policy applies to the chain as a whole: Fail
+    // is all-or-nothing and Block appends piecewise as room frees up.
+    // Returns the number of elements queued.
+    size_t push_bulk(Queue<T> items)
+    {
+        size_t pushed = 0;
+        std::unique_lock<std::mutex> guard(m_mutex);
+        while (!items.empty()) {
+            if (m_closed)
+                throw QueueClosed();
+            size_t room = m_capacity - std::min(m_capacity, m_buffer.size());
+            if (room < items.size()) {
+                switch (m_policy) {
+                case OverflowPolicy::Block:
+                    if (room == 0) {
+                        wait_not_full(guard);
+                        continue;
+                    }
+                    break;
+                case OverflowPolicy::DropNewest:
+                    m_dropped += items.size() - room;
+                    break;
+                case OverflowPolicy::DropOldest:
+                    if (items.size() > m_capacity) {
+                        m_dropped += items.size() - m_capacity;
+                        items.split_front(items.size() - m_capacity);
+                    }
+                    drop_front(m_buffer.size() + items.size() - m_capacity);
+                    room = items.size();
+                    break;
+                case OverflowPolicy::Fail:
+                    throw QueueFull();
+                }
+            }
+
+            Queue<T> chunk = items.split_front(room);
+            if (m_policy == OverflowPolicy::DropNewest)
+                items.clear();
+            size_t count = chunk.size();
+            m_buffer.splice(chunk);
+            m_count.fetch_add(count, std::memory_order_release);
+            pushed += count;
+
+            size_t wake = std::min(count, m_waiters);
+            guard.unlock();
+            notify(m_not_empty, wake);
+            guard.lock();
         }
-        m_cv.notify_one(); // Notify waiting threads after the lock is released
+        return pushed;
+    }
+
+    // Same for any range; the chain is built before the lock is taken
+    template <std::ranges::input_range Range> size_t push_bulk(Range &&range)
+    {
+        Queue<T> items;
+        for (auto &&item : range)
+            items.push(std::forward<decltype(item)>(item));
+        return push_bulk(std::move(items));
     }
 
-    // Pop element from the queue, blocks if the queue is empty
+    // Pop element from the queue, blocks if the queue is empty.
+    // Throws QueueClosed once the queue is closed and drained.
     T pop()
     {
         std::unique_lock<std::mutex> unique_guard(m_mutex);
-        // Wait until there's an element to pop
-        m_cv.wait(unique_guard, [&] { return !m_buffer.empty(); });
+        if (!wait_not_empty(unique_guard,
+                            [&](auto ready) { m_not_empty.wait(unique_guard, ready); }))
+            throw QueueClosed();
+        T front = take_front();
+        release_room(unique_guard, 1);
+        return front;
+    }
+
+    // Pop without blocking; nullopt if the queue is empty
+    std::optional<T> try_pop()
+    {
+        std::unique_lock<std::mutex> unique_guard(m_mutex);
+        if (m_buffer.empty())
+            return std::nullopt;
+        std::optional<T> front = take_front();
+        release_room(unique_guard, 1);
+        return front;
+    }
+
+    // Pop, waiting until `deadline` at most; nullopt on timeout or when the
+    // queue is closed and drained
+    template <typename Clock, typename Duration>
+    std::optional<T> pop_until(const std::chrono::time_point<Clock, Duration> &deadline)
+    {
+        std::unique_lock<std::mutex> unique_guard(m_mutex);
+        if (!wait_not_empty(unique_guard, [&](auto ready) {
+                m_not_empty.wait_until(unique_guard, deadline, ready);
+            }))
+            return std::nullopt;
+        std::optional<T> front = take_front();
+        release_room(unique_guard, 1);
+        return front;
+    }
+
+    template <typename Rep, typename Period>
+    std::optional<T> pop_for(const std::chrono::duration<Rep, Period> &timeout)
+    {
+        return pop_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    // Take up to `max` elements at once, blocks until there is at least one.
+    // Whole blocks are relinked under the lock; only the elements of the
+    // block the cut falls into are moved. Returns an empty queue once the
+    // queue is closed and drained, so `max` must be positive.
+    Queue<T> pop_bulk(size_t max)
+    {
+        if (max == 0)
+            throw std::invalid_argument("QueueSafe pop_bulk max must be positive");
+        std::unique_lock<std::mutex> unique_guard(m_mutex);
+        if (!wait_not_empty(unique_guard,
+                            [&](auto ready) { m_not_empty.wait(unique_guard, ready); }))
+            return Queue<T>();
+
+        Queue<T> items = m_buffer.split_front(max);
+        m_count.fetch_sub(items.size(), std::memory_order_relaxed);
+        release_room(unique_guard, items.size());
+        return items;
+    }
+
+    // Refuse further pushes and wake every waiting consumer and producer.
+    // The elements already queued can still be popped; after that pop()
+    // throws and the other pops return empty.
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_closed = true;
+        }
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+    }
+
+    bool closed() const
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        return m_closed;
+    }
+
+    // Lock-free, so it may be stale by the time it is used
+    size_t size() const noexcept { return m_count.load(std::memory_order_relaxed); }
+
+    size_t capacity() const noexcept { return m_capacity; }
+
+    // Elements discarded by the DropNewest and DropOldest policies so far
+    size_t dropped() const
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        return m_dropped;
+    }
 
+  private:
+    // Spin, then park(ready) until there is an element, the queue is closed
+    // or park gives up. Returns with the mutex held, true if there is an
+    // element to take.
+    template <typename Park>
+    bool wait_not_empty(std::unique_lock<std::mutex> &unique_guard, Park park)
+    {
+        if (m_buffer.empty() && !m_closed && (m_spin.spins || m_spin.yields)) {
+            // Catch a quick hand-off without sleeping in the kernel
+            unique_guard.unlock();
+            spin_until(m_spin, [this] { return m_count.load(std::memory_order_acquire) > 0; });
+            unique_guard.lock();
+        }
+        if (m_buffer.empty() && !m_closed) {
+            // Wait until there's an element to pop
+            ++m_waiters;
+            park([&] { return !m_buffer.empty() || m_closed; });
+            --m_waiters;
+        }
+        return !m_buffer.empty();
+    }
+
+    // Block a producer until there is room; throws if the queue gets closed
+    void wait_not_full(std::unique_lock<std::mutex> &guard)
+    {
+        ++m_producers;
+        m_not_full.wait(guard, [&] { return m_buffer.size() < m_capacity || m_closed; });
+        --m_producers;
+        if (m_closed)
+            throw QueueClosed();
+    }
+
+    // m_mutex must be held and the buffer non-empty
+    T take_front()
+    {
         T front = std::move(m_buffer.front()); // Move the front element
         m_buffer.pop();                        // Remove the front element
+        m_count.fetch_sub(1, std::memory_order_relaxed);
         return front;
     }
 
-  private:
-    Queue<T> m_buffer;            // Underlying buffer (Queue class implementation)
-    std::mutex m_mutex;           // Mutex for thread safety
-    std::condition_variable m_cv; // Condition variable to handle blocking
+    // m_mutex must be held
+    void drop_front(size_t count)
+    {
+        count = m_buffer.split_front(count).size();
+        m_count.fetch_sub(count, std::memory_order_relaxed);
+        m_dropped += count;
+    }
+
+    // Wake as many producers blocked on a full queue as `count` taken
+    // elements made room for; releases the lock
+    void release_room(std::unique_lock<std::mutex> &guard, size_t count)
+    {
+        size_t wake = std::min(count, m_producers);
+        guard.unlock();
+        notify(m_not_full, wake);
+    }
+
+    static void notify(std::condition_variable &cv, size_t wake)
+    {
+        for (size_t i = 0; i < wake; ++i)
+            cv.notify_one();
+    }
+
+    Queue<T> m_buffer;                   // Underlying buffer (Queue class implementation)
+    mutable std::mutex m_mutex;          // Mutex for thread safety
+    std::condition_variable m_not_empty; // Consumers wait here for elements
+    std::condition_variable m_not_full;  // Producers wait here for room
+    std::atomic<size_t> m_count{0};      // Lock-free size hint for spinning consumers
+    size_t m_waiters = 0;                // Consumers blocked on m_not_empty
+    size_t m_producers = 0;              // Producers blocked on m_not_full
+    size_t m_dropped = 0;                // Elements discarded by the overflow policy
+    size_t m_capacity = Unbounded;
+    OverflowPolicy m_policy = OverflowPolicy::Block;
+    bool m_closed = false; // Set by close(), never cleared
+    SpinPolicy m_spin = SpinPolicy::none();
 };
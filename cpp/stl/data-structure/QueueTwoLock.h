@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// Unbounded thread-safe FIFO queue with separate locks for the two ends
+// (Michael & Scott's two-lock queue). The list always starts with a dummy
+// node: producers only touch the tail under m_tail_mutex, consumers only the
+// head under m_head_mutex, so a push and a pop never wait for each other.
+// The only node both ends see is the dummy of an empty queue, whose `next`
+// is therefore atomic.
+//
+// Popped nodes are kept for reuse: consumers push them onto an atomic
+// retired list, and a producer whose own free list ran dry takes the whole
+// list with one exchange, so the steady state does not allocate and the
+// producer never needs the head lock to get a node.
+template <typename T> class QueueTwoLock
+{
+  public:
+    QueueTwoLock() : m_head(new Node()), m_tail(m_head) {}
+
+    ~QueueTwoLock()
+    {
+        while (try_pop()) {
+        }
+        delete m_head;
+        release_list(m_free);
+        release_list(m_retired.load(std::memory_order_relaxed));
+    }
+
+    QueueTwoLock(const QueueTwoLock &) = delete;
+    QueueTwoLock &operator=(const QueueTwoLock &) = delete;
+
+    void push(const T &value) { emplace(value); }
+
+    void push(T &&value) { emplace(std::move(value)); }
+
+    template <typename... Args> void emplace(Args &&...args)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_tail_mutex);
+            Node *node = acquire();
+            try {
+                std::construct_at(node->value(), std::forward<Args>(args)...);
+            } catch (...) {
+                node->next.store(m_free, std::memory_order_relaxed);
+                m_free = node;
+                throw;
+            }
+            node->next.store(nullptr, std::memory_order_relaxed);
+            // publishes the value; seq_cst pairs with the waiter count below
+            m_tail->next.store(node, std::memory_order_seq_cst);
+            m_tail = node;
+        }
+
+        if (m_waiters.load(std::memory_order_seq_cst) > 0) {
+            // a consumer checks for a node and parks under the head lock
+            std::lock_guard<std::mutex> guard(m_head_mutex);
+            m_not_empty.notify_one();
+        }
+    }
+
+    // nullopt if the queue is empty
+    std::optional<T> try_pop()
+    {
+        std::lock_guard<std::mutex> guard(m_head_mutex);
+        Node *next = m_head->next.load(std::memory_order_acquire);
+        if (!next)
+            return std::nullopt;
+        return take(next);
+    }
+
+    bool try_pop(T &out)
+    {
+        auto value = try_pop();
+        if (!value)
+            return false;
+        out = std::move(*value);
+        return true;
+    }
+
+    // Blocks until an element is available
+    T pop()
+    {
+        std::unique_lock<std::mutex> guard(m_head_mutex);
+        Node *next = m_head->next.load(std::memory_order_acquire);
+        if (!next) {
+            m_waiters.fetch_add(1, std::memory_order_seq_cst);
+            m_not_empty.wait(guard, [&] {
+                next = m_head->next.load(std::memory_order_seq_cst);
+                return next != nullptr;
+            });
+            m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return take(next);
+    }
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> guard(m_head_mutex);
+        return m_head->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+  private:
+    struct Node {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<Node *> next{nullptr};
+
+        T *value() noexcept { return reinterpret_cast<T *>(storage); }
+    };
+
+    // m_head_mutex must be held; `next` becomes the new dummy
+    T take(Node *next)
+    {
+        T value = std::move(*next->value());
+        std::destroy_at(next->value());
+
+        // consumers push one at a time under the head lock and the producer
+        // only ever takes the whole list, so a plain CAS loop has no ABA
+        Node *old = m_head;
+        m_head = next;
+        Node *retired = m_retired.load(std::memory_order_relaxed);
+        do {
+            old->next.store(retired, std::memory_order_relaxed);
+        } while (!m_retired.compare_exchange_weak(retired, old, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        return value;
+    }
+
+    // m_tail_mutex must be held
+    Node *acquire()
+    {
+        if (!m_free && m_retired.load(std::memory_order_relaxed))
+            m_free = m_retired.exchange(nullptr, std::memory_order_acquire);
+        if (!m_free)
+            return new Node; // the value storage stays raw
+        Node *node = m_free;
+        m_free = node->next.load(std::memory_order_relaxed);
+        return node;
+    }
+
+    static void release_list(Node *list)
+    {
+        while (list) {
+            delete std::exchange(list, list->next.load(std::memory_order_relaxed));
+        }
+    }
+
+    static constexpr size_t cache_line = 64;
+
+    // consumer side
+    alignas(cache_line) mutable std::mutex m_head_mutex;
+    Node *m_head;
+    std::atomic<Node *> m_retired{nullptr};
+    std::condition_variable m_not_empty;
+    std::atomic<size_t> m_waiters{0};
+
+    // producer side
+    alignas(cache_line) std::mutex m_tail_mutex;
+    Node *m_tail;
+    Node *m_free = nullptr;
+};
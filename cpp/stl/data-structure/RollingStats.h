@@ -0,0 +1,333 @@
+#pragma once
+
+#include "CircularBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ROLLING_STATS_X86 1
+#endif
+
+// Kernels over one contiguous run of samples. The AVX2 versions are compiled
+// with a target attribute, so the rest of the build needs no -mavx2, and are
+// only picked when the CPU reports AVX2 at run time.
+namespace rolling_detail
+{
+
+struct Moments {
+    double sum = 0;
+    double sum_sq = 0;
+};
+
+inline Moments moments_scalar(std::span<const double> xs)
+{
+    Moments m;
+    for (double x : xs) {
+        m.sum += x;
+        m.sum_sq += x * x;
+    }
+    return m;
+}
+
+inline std::pair<double, double> minmax_scalar(std::span<const double> xs)
+{
+    auto [lo, hi] = std::minmax_element(xs.begin(), xs.end());
+    return {*lo, *hi};
+}
+
+#ifdef ROLLING_STATS_X86
+__attribute__((target("avx2"))) inline double hsum(__m256d v)
+{
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+__attribute__((target("avx2"))) inline Moments moments_avx2(std::span<const double> xs)
+{
+    // two independent accumulators per sum hide the add latency
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d q0 = _mm256_setzero_pd(), q1 = _mm256_setzero_pd();
+    const double *p = xs.data();
+    size_t n = xs.size(), i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_loadu_pd(p + i);
+        __m256d b = _mm256_loadu_pd(p + i + 4);
+        s0 = _mm256_add_pd(s0, a);
+        s1 = _mm256_add_pd(s1, b);
+        q0 = _mm256_add_pd(q0, _mm256_mul_pd(a, a));
+        q1 = _mm256_add_pd(q1, _mm256_mul_pd(b, b));
+    }
+    Moments m{hsum(_mm256_add_pd(s0, s1)), hsum(_mm256_add_pd(q0, q1))};
+    Moments tail = moments_scalar(xs.subspan(i));
+    m.sum += tail.sum;
+    m.sum_sq += tail.sum_sq;
+    return m;
+}
+
+__attribute__((target("avx2"))) inline std::pair<double, double>
+minmax_avx2(std::span<const double> xs)
+{
+    const double *p = xs.data();
+    size_t n = xs.size(), i = 0;
+    if (n < 4) {
+        return minmax_scalar(xs);
+    }
+    __m256d lo = _mm256_loadu_pd(p), hi = lo;
+    for (i = 4; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(p + i);
+        lo = _mm256_min_pd(lo, v);
+        hi = _mm256_max_pd(hi, v);
+    }
+    alignas(32) double los[4], his[4];
+    _mm256_store_pd(los, lo);
+    _mm256_store_pd(his, hi);
+    double mn = std::min({los[0], los[1], los[2], los[3]});
+    double mx = std::max({his[0], his[1], his[2], his[3]});
+    for (; i < n; ++i) {
+        mn = std::min(mn, p[i]);
+        mx = std::max(mx, p[i]);
+    }
+    return {mn, mx};
+}
+#endif
+
+inline bool has_avx2()
+{
+#ifdef ROLLING_STATS_X86
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+inline Moments moments(std::span<const double> xs)
+{
+#ifdef ROLLING_STATS_X86
+    if (has_avx2()) {
+        return moments_avx2(xs);
+    }
+#endif
+    return moments_scalar(xs);
+}
+
+// xs must not be empty
+inline std::pair<double, double> minmax(std::span<const double> xs)
+{
+#ifdef ROLLING_STATS_X86
+    if (has_avx2()) {
+        return minmax_avx2(xs);
+    }
+#endif
+    return minmax_scalar(xs);
+}
+
+} // namespace rolling_detail
+
+// Statistics over the last `window` samples pushed, kept in a CircularBuffer.
+//
+// push() is O(1) (amortized for min/max): the sum and sum of squares are
+// updated incrementally as samples enter and leave the window, and min/max
+// come from monotonic deques of (sample index, value) whose fronts are the
+// current extremes. To bound floating-point drift the sums are recomputed
+// from the samples once per `window` evictions, which keeps push amortized
+// O(1).
+//
+// summary() recomputes everything in one pass over the buffer's two
+// contiguous spans with the SIMD kernels above. percentile() has to select,
+// so it is O(window).
+class RollingStats
+{
+  public:
+    struct Summary {
+        size_t count = 0;
+        double sum = 0;
+        double mean = 0;
+        double variance = 0; // population variance
+        double min = 0;
+        double max = 0;
+    };
+
+    explicit RollingStats(size_t window) : m_samples(window ? window : 1), m_window(window)
+    {
+        if (window == 0) {
+            throw std::invalid_argument("Window must be > 0");
+        }
+    }
+
+    void push(double x)
+    {
+        if (m_samples.size() == m_window) {
+            double old = m_samples.dequeue();
+            m_sum -= old;
+            m_sum_sq -= old * old;
+            ++m_evicted;
+        }
+        m_samples.enqueue(x);
+        m_sum += x;
+        m_sum_sq += x * x;
+        push_extremes(x);
+
+        if (m_evicted == m_window) {
+            m_evicted = 0;
+            recompute();
+        }
+    }
+
+    void push_bulk(std::span<const double> xs)
+    {
+        for (double x : xs) {
+            push(x);
+        }
+    }
+
+    size_t count() const { return m_samples.size(); }
+    size_t window() const { return m_window; }
+    bool empty() const { return m_samples.isEmpty(); }
+
+    double sum() const { return m_sum; }
+
+    double mean() const
+    {
+        check_not_empty();
+        return m_sum / static_cast<double>(count());
+    }
+
+    double variance() const
+    {
+        check_not_empty();
+        double n = static_cast<double>(count());
+        double mean = m_sum / n;
+        // cancellation can push it slightly below zero
+        return std::max(0.0, m_sum_sq / n - mean * mean);
+    }
+
+    double stddev() const { return std::sqrt(variance()); }
+
+    double min() const
+    {
+        check_not_empty();
+        return m_min.front().second;
+    }
+
+    double max() const
+    {
+        check_not_empty();
+        return m_max.front().second;
+    }
+
+    // Nearest-rank percentile, p in [0, 100]
+    double percentile(double p)
+    {
+        check_not_empty();
+        if (p < 0 || p > 100) {
+            throw std::out_of_range("Percentile must be in [0, 100]");
+        }
+        auto [first, second] = m_samples.peek_spans();
+        m_scratch.assign(first.begin(), first.end());
+        m_scratch.insert(m_scratch.end(), second.begin(), second.end());
+
+        size_t rank = static_cast<size_t>(std::ceil(p / 100 * m_scratch.size()));
+        auto nth = m_scratch.begin() + (rank ? rank - 1 : 0);
+        std::nth_element(m_scratch.begin(), nth, m_scratch.end());
+        return *nth;
+    }
+
+    // Every statistic recomputed from the samples in one pass
+    Summary summary() const
+    {
+        Summary s;
+        s.count = count();
+        if (s.count == 0) {
+            return s;
+        }
+        auto [first, second] = m_samples.peek_spans();
+        auto a = rolling_detail::moments(first);
+        auto [lo, hi] = rolling_detail::minmax(first);
+        if (!second.empty()) {
+            auto b = rolling_detail::moments(second);
+            auto [lo2, hi2] = rolling_detail::minmax(second);
+            a.sum += b.sum;
+            a.sum_sq += b.sum_sq;
+            lo = std::min(lo, lo2);
+            hi = std::max(hi, hi2);
+        }
+        double n = static_cast<double>(s.count);
+        s.sum = a.sum;
+        s.mean = a.sum / n;
+        s.variance = std::max(0.0, a.sum_sq / n - s.mean * s.mean);
+        s.min = lo;
+        s.max = hi;
+        return s;
+    }
+
+    // Resynchronize the running sums with the samples
+    void recompute()
+    {
+        auto [first, second] = m_samples.peek_spans();
+        auto a = rolling_detail::moments(first);
+        auto b = rolling_detail::moments(second);
+        m_sum = a.sum + b.sum;
+        m_sum_sq = a.sum_sq + b.sum_sq;
+    }
+
+    void clear()
+    {
+        while (!m_samples.isEmpty()) {
+            m_samples.dequeue();
+        }
+        m_min.clear();
+        m_max.clear();
+        m_sum = m_sum_sq = 0;
+        m_evicted = 0;
+    }
+
+  private:
+    void check_not_empty() const
+    {
+        if (empty()) {
+            throw std::out_of_range("Window is empty");
+        }
+    }
+
+    // x has just been enqueued as sample number m_pushed
+    void push_extremes(double x)
+    {
+        uint64_t index = m_pushed++;
+        while (!m_min.empty() && m_min.back().second >= x) {
+            m_min.pop_back();
+        }
+        while (!m_max.empty() && m_max.back().second <= x) {
+            m_max.pop_back();
+        }
+        m_min.emplace_back(index, x);
+        m_max.emplace_back(index, x);
+
+        // drop extremes that have left the window
+        if (m_min.front().first + m_window <= index) {
+            m_min.pop_front();
+        }
+        if (m_max.front().first + m_window <= index) {
+            m_max.pop_front();
+        }
+    }
+
+    CircularBuffer<double> m_samples;
+    size_t m_window;
+    double m_sum = 0;
+    double m_sum_sq = 0;
+    size_t m_evicted = 0; // evictions since the last recompute
+    uint64_t m_pushed = 0;
+    std::deque<std::pair<uint64_t, double>> m_min; // increasing values
+    std::deque<std::pair<uint64_t, double>> m_max; // decreasing values
+    std::vector<double> m_scratch;                 // reused by percentile()
+};
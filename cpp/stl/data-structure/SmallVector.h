@@ -0,0 +1,225 @@
+#pragma once
+
+#include "Vector.h"
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Vector with room for N elements inside the object itself: short lists
+// (adjacency lists, headers) never touch the allocator, and only a list that
+// grows past N spills to the heap. Same interface as Vector, plus
+// is_inline().
+//
+// Moving a heap-mode SmallVector steals the buffer; an inline one has to
+// move its elements, which for trivially relocatable types is one memcpy.
+// Unlike Vector, a SmallVector is not trivially relocatable itself, because
+// m_data points into the object while it is inline.
+template <typename Type, size_t N> struct SmallVector {
+    static_assert(N > 0, "use Vector for no inline elements");
+
+    // Default constructor
+    SmallVector() noexcept : m_data(inline_data()), m_size(0), m_capacity(N) {}
+
+    // Parameterized constructor
+    explicit SmallVector(size_t size) : SmallVector()
+    {
+        reserve(size);
+        std::uninitialized_value_construct_n(m_data, size); // Default initialize elements
+        m_size = size;
+    }
+
+    // Copy constructor
+    SmallVector(const SmallVector &other) : SmallVector()
+    {
+        reserve(other.m_size);
+        std::uninitialized_copy_n(other.m_data, other.m_size, m_data); // Deep copy elements
+        m_size = other.m_size;
+    }
+
+    // Move constructor
+    SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<Type>)
+        : SmallVector()
+    {
+        take(other);
+    }
+
+    // Destructor
+    ~SmallVector()
+    {
+        clear();
+        release();
+    }
+
+    // Copy assignment operator
+    SmallVector &operator=(const SmallVector &other)
+    {
+        if (this != &other) {
+            SmallVector temp(other);
+            *this = std::move(temp);
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    SmallVector &operator=(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<Type>)
+    {
+        if (this != &other) {
+            clear();
+            release();
+            take(other);
+        }
+        return *this;
+    }
+
+    void reserve(size_t new_capacity)
+    {
+        if (new_capacity > m_capacity) {
+            Type *new_data = static_cast<Type *>(
+                ::operator new(new_capacity * sizeof(Type), std::align_val_t(alignof(Type))));
+            try {
+                relocate(m_data, m_size, new_data); // Move elements to new storage
+            } catch (...) {
+                ::operator delete(new_data, std::align_val_t(alignof(Type)));
+                throw;
+            }
+            release();
+            m_data = new_data;
+            m_capacity = new_capacity;
+        }
+    }
+
+    void push_back(const Type &value) { emplace_back(value); }
+
+    void push_back(Type &&value) { emplace_back(std::move(value)); }
+
+    // Construct the new element in place
+    template <typename... Args> Type &emplace_back(Args &&...args)
+    {
+        if (m_size == m_capacity) {
+            // the arguments may refer to an element that growth relocates
+            Type value(std::forward<Args>(args)...);
+            reserve(m_capacity * 2);
+            return *std::construct_at(m_data + m_size++, std::move(value));
+        }
+        Type *slot = std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+        ++m_size;
+        return *slot;
+    }
+
+    void pop_back()
+    {
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        std::destroy_at(m_data + --m_size);
+    }
+
+    void clear() noexcept
+    {
+        std::destroy_n(m_data, m_size);
+        m_size = 0;
+    }
+
+    void swap(SmallVector &other)
+    {
+        SmallVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool is_inline() const { return m_data == inline_data(); }
+
+    // Access operator
+    Type &operator[](size_t index)
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        return m_data[index];
+    }
+
+    const Type &operator[](size_t index) const
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        return m_data[index];
+    }
+
+    // Iteration
+    Type *data() noexcept { return m_data; }
+    const Type *data() const noexcept { return m_data; }
+    Type *begin() noexcept { return m_data; }
+    Type *end() noexcept { return m_data + m_size; }
+    const Type *begin() const noexcept { return m_data; }
+    const Type *end() const noexcept { return m_data + m_size; }
+
+  private:
+    Type *m_data;
+    size_t m_size;
+    size_t m_capacity;
+    alignas(Type) unsigned char m_inline[N * sizeof(Type)];
+
+    Type *inline_data() noexcept { return reinterpret_cast<Type *>(m_inline); }
+    const Type *inline_data() const noexcept
+    {
+        return reinterpret_cast<const Type *>(m_inline);
+    }
+
+    // Move count elements from src to uninitialized dst and end their
+    // lifetime in src. If a throwing move fails, src is left as it was.
+    static void relocate(Type *src, size_t count, Type *dst)
+    {
+        if constexpr (is_trivially_relocatable<Type>::value) {
+            std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src),
+                        count * sizeof(Type));
+        } else {
+            size_t done = 0;
+            try {
+                for (; done < count; ++done) {
+                    std::construct_at(dst + done, std::move_if_noexcept(src[done]));
+                }
+            } catch (...) {
+                std::destroy_n(dst, done);
+                throw;
+            }
+            std::destroy_n(src, count);
+        }
+    }
+
+    // Free the heap buffer, if any, and go back to the inline storage. The
+    // elements must have been destroyed or relocated.
+    void release() noexcept
+    {
+        if (!is_inline()) {
+            ::operator delete(m_data, std::align_val_t(alignof(Type)));
+            m_data = inline_data();
+            m_capacity = N;
+        }
+    }
+
+    // We are empty and inline; take other's elements and leave it empty
+    void take(SmallVector &other)
+    {
+        if (other.is_inline()) {
+            if constexpr (is_trivially_relocatable<Type>::value) {
+                relocate(other.m_data, other.m_size, m_data);
+            } else {
+                std::uninitialized_move_n(other.m_data, other.m_size, m_data);
+                std::destroy_n(other.m_data, other.m_size);
+            }
+        } else {
+            m_data = std::exchange(other.m_data, other.inline_data());
+            m_capacity = std::exchange(other.m_capacity, N);
+        }
+        m_size = std::exchange(other.m_size, 0);
+    }
+};
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "Vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Vector of records stored as a structure of arrays: field I of every record
+// lives in its own contiguous column, aligned to 64 bytes, so a loop over
+// two fields only pulls those two columns through the cache and column<I>()
+// can be handed to SIMD code as a plain span.
+//
+// soa[i] returns a tuple of references to the fields of record i, which
+// works with structured bindings. push_back and reserve grow like Vector:
+// capacity doubles, and columns are relocated with memcpy for trivially
+// relocatable fields and by move otherwise. If any field could throw while
+// moving, growth copies every column, so a failure leaves the vector as it
+// was.
+template <typename... Fields> struct SoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+
+    template <size_t I> using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    static constexpr size_t column_alignment = 64;
+
+    // Default constructor
+    SoAVector() noexcept = default;
+
+    // Parameterized constructor: size value-initialized records. Both
+    // constructors delegate, so the destructor frees the columns on a throw.
+    explicit SoAVector(size_t size) : SoAVector()
+    {
+        reserve(size);
+        for_each_column(
+            [&](auto I) { std::uninitialized_value_construct_n(column_data<I>(), size); },
+            [&](auto I) { std::destroy_n(column_data<I>(), size); });
+        m_size = size;
+    }
+
+    // Copy constructor
+    SoAVector(const SoAVector &other) : SoAVector()
+    {
+        reserve(other.m_size);
+        for_each_column(
+            [&](auto I) {
+                std::uninitialized_copy_n(other.template column_data<I>(), other.m_size,
+                                          column_data<I>());
+            },
+            [&](auto I) { std::destroy_n(column_data<I>(), other.m_size); });
+        m_size = other.m_size;
+    }
+
+    // Move constructor
+    SoAVector(SoAVector &&other) noexcept
+        : m_columns(std::exchange(other.m_columns, {})),
+          m_size(std::exchange(other.m_size, 0)),
+          m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    // Destructor
+    ~SoAVector()
+    {
+        clear();
+        deallocate(m_columns);
+    }
+
+    // Copy assignment operator
+    SoAVector &operator=(const SoAVector &other)
+    {
+        if (this != &other) {
+            SoAVector temp(other);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    SoAVector &operator=(SoAVector &&other) noexcept
+    {
+        if (this != &other) {
+            SoAVector temp(std::move(other));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    void reserve(size_t new_capacity)
+    {
+        if (new_capacity > m_capacity) {
+            Columns new_columns = allocate(new_capacity);
+            relocate(new_columns); // Move elements to new storage
+            deallocate(m_columns);
+            m_columns = new_columns;
+            m_capacity = new_capacity;
+        }
+    }
+
+    // Append one record, one value per field
+    void push_back(const Fields &...values)
+    {
+        emplace_back_tuple(std::forward_as_tuple(values...));
+    }
+
+    void push_back(Fields &&...values)
+    {
+        emplace_back_tuple(std::forward_as_tuple(std::move(values)...));
+    }
+
+    void pop_back()
+    {
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        --m_size;
+        std::apply([&](Fields *...columns) { (std::destroy_at(columns + m_size), ...); },
+                   m_columns);
+    }
+
+    void clear() noexcept
+    {
+        std::apply([&](Fields *...columns) { (std::destroy_n(columns, m_size), ...); },
+                   m_columns);
+        m_size = 0;
+    }
+
+    void swap(SoAVector &other) noexcept
+    {
+        std::swap(m_columns, other.m_columns);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+    // Access operator: references to the fields of one record
+    std::tuple<Fields &...> operator[](size_t index)
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        return std::apply([&](Fields *...columns) { return std::tie(columns[index]...); },
+                          m_columns);
+    }
+
+    std::tuple<const Fields &...> operator[](size_t index) const
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        return std::apply(
+            [&](Fields *const... columns) {
+                return std::tuple<const Fields &...>(columns[index]...);
+            },
+            m_columns);
+    }
+
+    // Field I of every record, contiguous and 64-byte aligned
+    template <size_t I> std::span<field_type<I>> column() noexcept
+    {
+        return {column_data<I>(), m_size};
+    }
+
+    template <size_t I> std::span<const field_type<I>> column() const noexcept
+    {
+        return {column_data<I>(), m_size};
+    }
+
+  private:
+    using Columns = std::tuple<Fields *...>;
+
+    Columns m_columns{};
+    size_t m_size = 0;
+    size_t m_capacity = 0;
+
+    template <size_t I> field_type<I> *column_data() noexcept { return std::get<I>(m_columns); }
+    template <size_t I> const field_type<I> *column_data() const noexcept
+    {
+        return std::get<I>(m_columns);
+    }
+
+    template <typename Field> static constexpr std::align_val_t alignment_of()
+    {
+        return std::align_val_t(std::max(column_alignment, alignof(Field)));
+    }
+
+    // Call fill(column index) for every column. If one throws, undo(index)
+    // runs for the columns already filled, then the exception propagates.
+    template <size_t I = 0, typename Fill, typename Undo>
+    static void for_each_column(Fill &&fill, Undo &&undo)
+    {
+        if constexpr (I < sizeof...(Fields)) {
+            fill(std::integral_constant<size_t, I>{});
+            try {
+                for_each_column<I + 1>(fill, undo);
+            } catch (...) {
+                undo(std::integral_constant<size_t, I>{});
+                throw;
+            }
+        }
+    }
+
+    // All columns or none
+    static Columns allocate(size_t count)
+    {
+        Columns columns{};
+        for_each_column(
+            [&](auto I) {
+                using Field = field_type<I>;
+                std::get<I>(columns) = static_cast<Field *>(
+                    ::operator new(count * sizeof(Field), alignment_of<Field>()));
+            },
+            [&](auto I) {
+                ::operator delete(std::get<I>(columns), alignment_of<field_type<I>>());
+            });
+        return columns;
+    }
+
+    static void deallocate(Columns columns) noexcept
+    {
+        std::apply(
+            [](Fields *...data) { (::operator delete(data, alignment_of<Fields>()), ...); },
+            columns);
+    }
+
+    // Growth may move only if no column can throw halfway
+    static constexpr bool nothrow_relocation =
+        ((is_trivially_relocatable<Fields>::value ||
+          std::is_nothrow_move_constructible_v<Fields>) &&
+         ...);
+
+    // Move (or copy) every record into new_columns and end the old ones. On
+    // an exception the old columns are untouched and new_columns is
+    // released.
+    void relocate(Columns &new_columns)
+    {
+        try {
+            for_each_column(
+                [&](auto I) {
+                    using Field = field_type<I>;
+                    Field *from = column_data<I>();
+                    Field *to = std::get<I>(new_columns);
+                    if constexpr (is_trivially_relocatable<Field>::value) {
+                        if (m_size) {
+                            std::memcpy(static_cast<void *>(to), static_cast<void *>(from),
+                                        m_size * sizeof(Field));
+                        }
+                    } else if constexpr (nothrow_relocation) {
+                        std::uninitialized_move_n(from, m_size, to);
+                    } else {
+                        std::uninitialized_copy_n(from, m_size, to);
+                    }
+                },
+                [&](auto I) {
+                    if constexpr (!is_trivially_relocatable<field_type<I>>::value) {
+                        std::destroy_n(std::get<I>(new_columns), m_size);
+                    }
+                });
+        } catch (...) {
+            deallocate(new_columns);
+            throw;
+        }
+        for_each_column(
+            [&](auto I) {
+                if constexpr (!is_trivially_relocatable<field_type<I>>::value) {
+                    std::destroy_n(column_data<I>(), m_size);
+                }
+            },
+            [](auto) {});
+    }
+
+    // values is a tuple of references; they may point into this vector, so
+    // growth first copies them out
+    template <typename Tuple> void emplace_back_tuple(Tuple &&values)
+    {
+        if (m_size == m_capacity) {
+            std::tuple<Fields...> copy(std::forward<Tuple>(values));
+            reserve(m_capacity == 0 ? 1 : m_capacity * 2);
+            construct_back(std::move(copy));
+        } else {
+            construct_back(std::forward<Tuple>(values));
+        }
+    }
+
+    template <typename Tuple> void construct_back(Tuple &&values)
+    {
+        for_each_column(
+            [&](auto I) {
+                std::construct_at(column_data<I>() + m_size,
+                                  std::get<I>(std::forward<Tuple>(values)));
+            },
+            [&](auto I) { std::destroy_at(column_data<I>() + m_size); });
+        ++m_size;
+    }
+};
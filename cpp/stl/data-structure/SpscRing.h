@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+// Lock-free ring buffer for exactly one producer thread and one consumer
+// thread (the concurrent sibling of CircularBuffer, which overwrites instead
+// of refusing when full).
+//
+// The capacity is rounded up to a power of two so indices are masked instead
+// of taken modulo. Head and tail only ever grow; each side owns one of them
+// on its own cache line together with a cached copy of the other side's
+// index, and only reloads the shared one when the cached copy says the ring
+// is full (producer) or empty (consumer). Publishing uses release stores and
+// observing uses acquire loads, nothing stronger.
+template <typename T> class SpscRing
+{
+  public:
+    explicit SpscRing(size_t capacity)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("Capacity must be > 0");
+        size_t slots = 1;
+        while (slots < capacity) {
+            if (slots > (SIZE_MAX >> 1))
+                throw std::length_error("SpscRing capacity too large");
+            slots <<= 1;
+        }
+        m_mask = slots - 1;
+        m_slots = std::allocator<T>().allocate(slots);
+    }
+
+    ~SpscRing()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        for (; head != tail; ++head)
+            std::destroy_at(&m_slots[head & m_mask]);
+        std::allocator<T>().deallocate(m_slots, m_mask + 1);
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    // Producer side: false if the ring is full
+    template <typename... Args> bool try_emplace(Args &&...args)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cached_head > m_mask) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail - m_cached_head > m_mask)
+                return false;
+        }
+        std::construct_at(&m_slots[tail & m_mask], std::forward<Args>(args)...);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T &value) { return try_emplace(value); }
+    bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+    // Producer side: copy as many items as fit, returns how many. If a copy
+    // throws, nothing of the batch is published and the exception propagates.
+    size_t write(std::span<const T> items)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t room = capacity() - (tail - m_cached_head);
+        if (room < items.size()) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            room = capacity() - (tail - m_cached_head);
+        }
+        size_t count = std::min(room, items.size());
+        size_t i = 0;
+        try {
+            for (; i < count; ++i)
+                std::construct_at(&m_slots[(tail + i) & m_mask], items[i]);
+        } catch (...) {
+            // unpublished, so no consumer can see these slots
+            for (size_t done = 0; done < i; ++done)
+                std::destroy_at(&m_slots[(tail + done) & m_mask]);
+            throw;
+        }
+        // one release store publishes the whole batch
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side: false if the ring is empty
+    bool try_pop(T &out)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cached_tail)
+                return false;
+        }
+        T &slot = m_slots[head & m_mask];
+        out = std::move(slot);
+        std::destroy_at(&slot);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> try_pop()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cached_tail)
+                return std::nullopt;
+        }
+        T &slot = m_slots[head & m_mask];
+        std::optional<T> value(std::move(slot));
+        std::destroy_at(&slot);
+        m_head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Consumer side: move up to out.size() items into out, returns how many.
+    // If a move throws, the items moved so far are consumed, the one that
+    // failed stays in the ring, and the exception propagates.
+    size_t read(std::span<T> out)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t available = m_cached_tail - head;
+        if (available < out.size()) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            available = m_cached_tail - head;
+        }
+        size_t count = std::min(available, out.size());
+        size_t i = 0;
+        try {
+            for (; i < count; ++i) {
+                T &slot = m_slots[(head + i) & m_mask];
+                out[i] = std::move(slot);
+                std::destroy_at(&slot);
+            }
+        } catch (...) {
+            // the first i slots are already destroyed; never revisit them
+            m_head.store(head + i, std::memory_order_release);
+            throw;
+        }
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Approximate unless called from the producer or the consumer thread
+    size_t size() const noexcept
+    {
+        // head first: it never passes the tail loaded after it
+        size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+    bool empty() const noexcept { return size() == 0; }
+    size_t capacity() const noexcept { return m_mask + 1; }
+
+  private:
+    static constexpr size_t cache_line = 64;
+
+    // producer's line
+    alignas(cache_line) std::atomic<size_t> m_tail{0};
+    size_t m_cached_head = 0;
+    // consumer's line
+    alignas(cache_line) std::atomic<size_t> m_head{0};
+    size_t m_cached_tail = 0;
+    // read-only after construction
+    alignas(cache_line) T *m_slots = nullptr;
+    size_t m_mask = 0;
+};
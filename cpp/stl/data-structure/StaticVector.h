@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Array.h"
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Vector with a fixed capacity of N elements stored inside the object, for
+// hot paths with a known upper bound: it never allocates. Elements are
+// constructed in place in a raw byte Array, which is left uninitialized
+// until they are. push_back / emplace_back throw std::length_error when
+// full; try_push reports it instead.
+//
+// When Type is trivially copyable, so is StaticVector, and it can be
+// memcpy'd as a whole, e.g. into a message. Copying always covers all N
+// slots in that case. Like std::inplace_vector, a moved-from StaticVector
+// keeps its size and holds moved-from elements.
+//
+// Access follows Array: operator[] is unchecked, at() throws.
+template <typename Type, size_t N> struct StaticVector {
+    static_assert(N > 0, "StaticVector needs a capacity");
+
+    // When each special member can be the defaulted, trivial one
+    static constexpr bool trivial_copy = std::is_trivially_copy_constructible_v<Type>;
+    static constexpr bool trivial_move = std::is_trivially_move_constructible_v<Type>;
+    static constexpr bool trivial_destroy = std::is_trivially_destructible_v<Type>;
+    static constexpr bool trivial_copy_assign =
+        trivial_copy && trivial_destroy && std::is_trivially_copy_assignable_v<Type>;
+    static constexpr bool trivial_move_assign =
+        trivial_move && trivial_destroy && std::is_trivially_move_assignable_v<Type>;
+
+    // Default constructor
+    StaticVector() noexcept {}
+
+    // Parameterized constructor: size value-initialized elements
+    explicit StaticVector(size_t size)
+    {
+        check_room(size);
+        std::uninitialized_value_construct_n(data(), size);
+        m_size = size;
+    }
+
+    // Copy constructor; trivial for trivially copyable types
+    StaticVector(const StaticVector &other)
+        requires trivial_copy
+    = default;
+    StaticVector(const StaticVector &other)
+        requires(!trivial_copy && std::is_copy_constructible_v<Type>)
+    {
+        std::uninitialized_copy_n(other.data(), other.m_size, data());
+        m_size = other.m_size;
+    }
+
+    // Move constructor
+    StaticVector(StaticVector &&other)
+        requires trivial_move
+    = default;
+    StaticVector(StaticVector &&other) noexcept(std::is_nothrow_move_constructible_v<Type>)
+        requires(!trivial_move)
+    {
+        std::uninitialized_move_n(other.data(), other.m_size, data());
+        m_size = other.m_size;
+    }
+
+    // Destructor
+    ~StaticVector()
+        requires trivial_destroy
+    = default;
+    ~StaticVector()
+        requires(!trivial_destroy)
+    {
+        clear();
+    }
+
+    // Copy assignment operator
+    StaticVector &operator=(const StaticVector &other)
+        requires trivial_copy_assign
+    = default;
+    StaticVector &operator=(const StaticVector &other)
+        requires(!trivial_copy_assign && std::is_copy_constructible_v<Type>)
+    {
+        if (this != &other) {
+            clear();
+            std::uninitialized_copy_n(other.data(), other.m_size, data());
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    StaticVector &operator=(StaticVector &&other)
+        requires trivial_move_assign
+    = default;
+    StaticVector &operator=(StaticVector &&other) noexcept(
+        std::is_nothrow_move_constructible_v<Type>)
+        requires(!trivial_move_assign)
+    {
+        if (this != &other) {
+            clear();
+            std::uninitialized_move_n(other.data(), other.m_size, data());
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    void push_back(const Type &value) { emplace_back(value); }
+
+    void push_back(Type &&value) { emplace_back(std::move(value)); }
+
+    // Construct the new element in place; throws std::length_error if full
+    template <typename... Args> Type &emplace_back(Args &&...args)
+    {
+        check_room(m_size + 1);
+        Type *slot = std::construct_at(data() + m_size, std::forward<Args>(args)...);
+        ++m_size;
+        return *slot;
+    }
+
+    // Append unless full; returns whether the value was added
+    bool try_push(const Type &value) { return try_emplace_back(value) != nullptr; }
+
+    bool try_push(Type &&value) { return try_emplace_back(std::move(value)) != nullptr; }
+
+    // Construct the new element in place, or return nullptr if full
+    template <typename... Args> Type *try_emplace_back(Args &&...args)
+    {
+        if (full()) {
+            return nullptr;
+        }
+        Type *slot = std::construct_at(data() + m_size, std::forward<Args>(args)...);
+        ++m_size;
+        return slot;
+    }
+
+    void pop_back()
+    {
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        std::destroy_at(data() + --m_size);
+    }
+
+    void clear() noexcept
+    {
+        std::destroy_n(data(), m_size);
+        m_size = 0;
+    }
+
+    bool empty() const { return m_size == 0; }
+    bool full() const { return m_size == N; }
+    size_t size() const { return m_size; }
+    static constexpr size_t capacity() noexcept { return N; }
+
+    // Unchecked element access
+    Type &operator[](size_t index) noexcept { return data()[index]; }
+    const Type &operator[](size_t index) const noexcept { return data()[index]; }
+
+    // Checked element access
+    Type &at(size_t index)
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        return data()[index];
+    }
+
+    const Type &at(size_t index) const
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        return data()[index];
+    }
+
+    // Iteration
+    Type *data() noexcept { return reinterpret_cast<Type *>(m_storage.data()); }
+    const Type *data() const noexcept
+    {
+        return reinterpret_cast<const Type *>(m_storage.data());
+    }
+    Type *begin() noexcept { return data(); }
+    Type *end() noexcept { return data() + m_size; }
+    const Type *begin() const noexcept { return data(); }
+    const Type *end() const noexcept { return data() + m_size; }
+
+  private:
+    size_t m_size = 0;
+    Array<unsigned char, N * sizeof(Type), alignof(Type)> m_storage;
+
+    static void check_room(size_t size)
+    {
+        if (size > N) {
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+    }
+};
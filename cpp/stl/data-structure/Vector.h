@@ -1,102 +1,176 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
+// A type is trivially relocatable when moving an object to a new address and
+// dropping the old one is the same as copying its bytes. Trivially copyable
+// types always are; specialize this for others that are too (e.g. types
+// that only own heap memory through a pointer, like Vector itself).
+template <typename Type> struct is_trivially_relocatable : std::is_trivially_copyable<Type> {
+};
+
+// Dynamic array over uninitialized storage: slots past size() hold no
+// objects. Elements are constructed in place with placement new and destroyed
+// explicitly. Growth relocates trivially relocatable types with realloc (one
+// memcpy at most), and otherwise moves elements when their move constructor
+// is noexcept, falling back to copies so a throwing move cannot lose data.
+//
+// Storage comes from the global heap, or from a std::pmr::memory_resource
+// passed to the constructor (e.g. a MonotonicArena for per-request data).
+// The resource stays with the vector: copies get the global heap unless one
+// is given, moves take it along, and assigning from a vector with another
+// resource moves or copies the elements into ours.
 template <typename Type> struct Vector {
     // Default constructor
-    Vector() noexcept : m_data(nullptr), m_size(0), m_capacity(0){};
+    Vector() noexcept : m_data(nullptr), m_size(0), m_capacity(0), m_resource(nullptr){};
+
+    // Empty vector allocating from resource (nullptr for the global heap)
+    explicit Vector(std::pmr::memory_resource *resource) noexcept
+        : m_data(nullptr), m_size(0), m_capacity(0), m_resource(resource)
+    {
+    }
 
     // Parameterized constructor
-    explicit Vector(size_t size) : m_size(size), m_capacity(size)
+    explicit Vector(size_t size, std::pmr::memory_resource *resource = nullptr)
+        : m_data(nullptr), m_size(0), m_capacity(0), m_resource(resource)
     {
-        m_data = new Type[m_capacity];
-        for (size_t i = 0; i < m_size; ++i) {
-            m_data[i] = Type(); // Default initialize elements
+        m_data = allocate(size);
+        m_capacity = size;
+        try {
+            std::uninitialized_value_construct_n(m_data, size); // Default initialize elements
+        } catch (...) {
+            deallocate(m_data, m_capacity);
+            throw;
         }
+        m_size = size;
     }
 
     // Copy constructor
-    Vector(const Vector &other) : m_size(other.m_size), m_capacity(other.m_capacity)
+    Vector(const Vector &other, std::pmr::memory_resource *resource = nullptr)
+        : m_data(nullptr), m_size(0), m_capacity(0), m_resource(resource)
     {
-        m_data = new Type[m_capacity];
-        for (size_t i = 0; i < m_size; ++i) {
-            m_data[i] = other.m_data[i]; // Deep copy elements
+        m_data = allocate(other.m_size);
+        m_capacity = other.m_size;
+        try {
+            std::uninitialized_copy_n(other.m_data, other.m_size, m_data); // Deep copy elements
+        } catch (...) {
+            deallocate(m_data, m_capacity);
+            throw;
         }
+        m_size = other.m_size;
     }
 
     // Move constructor
-    Vector(Vector &&other)
-        : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity)
+    Vector(Vector &&other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0)),
+          m_capacity(std::exchange(other.m_capacity, 0)), // Reset moved-from object
+          m_resource(other.m_resource)
     {
-        other.m_data = nullptr; // Reset moved-from object
-        other.m_size = 0;
-        other.m_capacity = 0;
     }
 
     // Destructor
     ~Vector()
     {
-        delete[] m_data;
-        m_data = nullptr; // Avoid dangling pointer
-        m_size = 0;
-        m_capacity = 0; // Reset size and capacity
+        std::destroy_n(m_data, m_size);
+        deallocate(m_data, m_capacity);
     }
 
     // Copy assignment operator
     Vector &operator=(const Vector &other)
     {
         if (this != &other) {
-            Vector temp(other);
-            std::swap(temp, *this);
+            Vector temp(other, m_resource);
+            swap(temp);
         }
         return *this;
     }
 
-    // Move assignment operator
+    // Move assignment operator; only allocates if the resources differ
     Vector &operator=(Vector &&other)
     {
-        if (this != &other) {
-            delete[] m_data;
-            m_data = other.m_data;
-            m_size = other.m_size;
-            m_capacity = other.m_capacity;
-            other.m_data = nullptr; // Reset moved-from object
-            other.m_size = 0;
-            other.m_capacity = 0;
+        if (this == &other) {
+            return *this;
+        }
+        if (m_resource != other.m_resource) {
+            Vector temp(m_resource);
+            temp.reserve(other.m_size);
+            for (Type &value : other) {
+                temp.emplace_back(std::move_if_noexcept(value));
+            }
+            swap(temp);
+            other.clear();
+            return *this;
         }
+        std::destroy_n(m_data, m_size);
+        deallocate(m_data, m_capacity);
+        m_data = std::exchange(other.m_data, nullptr); // Reset moved-from object
+        m_size = std::exchange(other.m_size, 0);
+        m_capacity = std::exchange(other.m_capacity, 0);
         return *this;
     }
 
     void reserve(size_t new_capacity)
     {
         if (new_capacity > m_capacity) {
-            Type *new_data = new Type[new_capacity];
-            for (size_t i = 0; i < m_size; ++i) {
-                new_data[i] = std::move(m_data[i]); // Move elements to new storage
+            if (!try_realloc(new_capacity)) {
+                Type *new_data = allocate(new_capacity);
+                try {
+                    relocate(new_data); // Move elements to new storage
+                } catch (...) {
+                    deallocate(new_data, new_capacity);
+                    throw;
+                }
+                m_data = new_data;
             }
-            delete[] m_data;           // Free old storage
-            m_data = new_data;         // Point to new storage
             m_capacity = new_capacity; // Update capacity
         }
     }
 
-    void push_back(const Type &value)
+    void push_back(const Type &value) { emplace_back(value); }
+
+    void push_back(Type &&value) { emplace_back(std::move(value)); }
+
+    // Construct the new element in place
+    template <typename... Args> Type &emplace_back(Args &&...args)
     {
-        ensure_capacity();
-        m_data[m_size++] = value;
+        if (m_size == m_capacity) {
+            return emplace_back_grow(std::forward<Args>(args)...);
+        }
+        Type *slot = std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+        ++m_size;
+        return *slot;
     }
 
-    void push_back(Type &&value)
+    void pop_back()
     {
-        ensure_capacity();
-        m_data[m_size++] = std::move(value); // Move new element
+        if (empty()) {
+            throw std::out_of_range("Vector is empty");
+        }
+        std::destroy_at(m_data + --m_size);
     }
 
-    template <typename... Args> void emplace_back(Args &&...args)
+    void clear() noexcept
     {
-        ensure_capacity();
-        m_data[m_size++] = Type(std::forward<Args>(args)...);
+        std::destroy_n(m_data, m_size);
+        m_size = 0;
+    }
+
+    // Both vectors should use the same resource; it is swapped as well
+    void swap(Vector &other) noexcept
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_resource, other.m_resource);
     }
 
     bool empty() const
@@ -113,24 +187,157 @@ template <typename Type> struct Vector {
     {
         return m_capacity; // Return current capacity
     }
+
+    // The memory resource, nullptr for the global heap
+    std::pmr::memory_resource *resource() const noexcept { return m_resource; }
+
     // Access operator
     Type &operator[](size_t index)
     {
-        if (index < 0 || index >= m_size) {
+        if (index >= m_size) {
             throw std::out_of_range("Index out of bounds");
         }
         return m_data[index];
     }
 
+    const Type &operator[](size_t index) const
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        return m_data[index];
+    }
+
+    // Iteration
+    Type *data() noexcept { return m_data; }
+    const Type *data() const noexcept { return m_data; }
+    Type *begin() noexcept { return m_data; }
+    Type *end() noexcept { return m_data + m_size; }
+    const Type *begin() const noexcept { return m_data; }
+    const Type *end() const noexcept { return m_data + m_size; }
+
   private:
+    // realloc only guarantees max_align_t alignment
+    static constexpr bool use_realloc =
+        is_trivially_relocatable<Type>::value && alignof(Type) <= alignof(std::max_align_t);
+
     Type *m_data;
     size_t m_size;
     size_t m_capacity;
+    std::pmr::memory_resource *m_resource; // nullptr: global heap
 
-    void ensure_capacity()
+    Type *allocate(size_t count)
     {
-        if (m_size >= m_capacity) {
-            reserve(m_capacity == 0 ? 1 : m_capacity * 2);
+        if (count == 0) {
+            return nullptr;
+        }
+        if (m_resource) {
+            return static_cast<Type *>(
+                m_resource->allocate(count * sizeof(Type), alignof(Type)));
         }
+        if constexpr (use_realloc) {
+            void *data = std::malloc(count * sizeof(Type));
+            if (!data) {
+                throw std::bad_alloc();
+            }
+            return static_cast<Type *>(data);
+        } else {
+            return static_cast<Type *>(
+                ::operator new(count * sizeof(Type), std::align_val_t(alignof(Type))));
+        }
+    }
+
+    void deallocate(Type *data, size_t count) noexcept
+    {
+        if (!data) {
+            return;
+        }
+        if (m_resource) {
+            m_resource->deallocate(data, count * sizeof(Type), alignof(Type));
+        } else if constexpr (use_realloc) {
+            std::free(data);
+        } else {
+            ::operator delete(data, std::align_val_t(alignof(Type)));
+        }
+    }
+
+    // Move (or copy, if moving may throw) the elements into new_data and
+    // release the old storage. On an exception the old storage is untouched
+    // and new_data is left empty.
+    void relocate(Type *new_data)
+    {
+        if constexpr (is_trivially_relocatable<Type>::value) {
+            if (m_size) {
+                std::memcpy(static_cast<void *>(new_data), static_cast<void *>(m_data),
+                            m_size * sizeof(Type));
+            }
+        } else {
+            size_t done = 0;
+            try {
+                for (; done < m_size; ++done) {
+                    std::construct_at(new_data + done, std::move_if_noexcept(m_data[done]));
+                }
+            } catch (...) {
+                std::destroy_n(new_data, done);
+                throw;
+            }
+            std::destroy_n(m_data, m_size);
+        }
+        deallocate(m_data, m_capacity);
     }
-};
\ No newline at end of file
+
+    // Grow in place (or with one memcpy) when the elements may be moved as
+    // bytes and the storage came from malloc
+    bool try_realloc(size_t new_capacity)
+    {
+        if constexpr (use_realloc) {
+            if (!m_resource) {
+                // the cast states that moving the bytes is intended
+                void *new_data =
+                    std::realloc(static_cast<void *>(m_data), new_capacity * sizeof(Type));
+                if (!new_data) {
+                    throw std::bad_alloc();
+                }
+                m_data = static_cast<Type *>(new_data);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t next_capacity() const { return m_capacity == 0 ? 1 : m_capacity * 2; }
+
+    // The arguments may refer to an element of this vector, so the new
+    // element is built before the old storage goes away
+    template <typename... Args> Type &emplace_back_grow(Args &&...args)
+    {
+        size_t new_capacity = next_capacity();
+        if (use_realloc && !m_resource) {
+            Type value(std::forward<Args>(args)...);
+            reserve(new_capacity);
+            std::construct_at(m_data + m_size, std::move(value));
+        } else {
+            Type *new_data = allocate(new_capacity);
+            try {
+                std::construct_at(new_data + m_size, std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(new_data, new_capacity);
+                throw;
+            }
+            try {
+                relocate(new_data);
+            } catch (...) {
+                std::destroy_at(new_data + m_size);
+                deallocate(new_data, new_capacity);
+                throw;
+            }
+            m_data = new_data;
+            m_capacity = new_capacity;
+        }
+        return m_data[m_size++];
+    }
+};
+
+// A Vector only owns heap memory, so its bytes can be moved as they are
+template <typename Type> struct is_trivially_relocatable<Vector<Type>> : std::true_type {
+};
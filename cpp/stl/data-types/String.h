@@ -1,28 +1,35 @@
 #pragma once
 
-#include <cstring>   // for std::strlen, std::copy
-#include <stdexcept> // for std::out_of_range
-#include <memory>
+#include <algorithm>       // for std::copy
+#include <cstring>         // for std::strlen
+#include <memory_resource> // for std::pmr::memory_resource
+#include <stdexcept>       // for std::out_of_range
+#include <utility>         // for std::exchange
 
+// Owning, null-terminated string. The characters live on the global heap, or
+// in a std::pmr::memory_resource passed to the constructor (e.g. a
+// MonotonicArena). Copies get the global heap unless a resource is given,
+// moves take the resource along.
 struct String {
   public:
     // Default / C-string constructor
-    explicit String(const char *str = "")
-        : m_size(std::strlen(str)), m_data(std::make_unique<char[]>(m_size + 1))
+    explicit String(const char *str = "", std::pmr::memory_resource *resource = nullptr)
+        : m_size(std::strlen(str)), m_resource(resource), m_data(allocate(m_size + 1))
     {
-        std::copy(str, str + m_size + 1, m_data.get()); // Copy with null terminator
+        std::copy(str, str + m_size + 1, m_data); // Copy with null terminator
     }
 
     // Copy constructor
-    String(const String &other)
-        : m_size(other.m_size), m_data(std::make_unique<char[]>(other.m_size + 1))
+    String(const String &other, std::pmr::memory_resource *resource = nullptr)
+        : m_size(other.m_size), m_resource(resource), m_data(allocate(other.m_size + 1))
     {
-        std::copy(other.m_data.get(), other.m_data.get() + m_size + 1, m_data.get());
+        std::copy(other.m_data, other.m_data + m_size + 1, m_data);
     }
 
     // Move constructor
     String(String &&other) noexcept
-        : m_size(std::exchange(other.m_size, 0)), m_data(std::move(other.m_data))
+        : m_size(std::exchange(other.m_size, 0)), m_resource(other.m_resource),
+          m_data(std::exchange(other.m_data, nullptr))
     {
     }
 
@@ -30,37 +37,47 @@ struct String {
     String &operator=(const String &other)
     {
         if (this != &other) {
+            char *data = allocate(other.m_size + 1);
+            std::copy(other.m_data, other.m_data + other.m_size + 1, data);
+            release();
             m_size = other.m_size;
-            m_data.reset(new char[m_size + 1]);
-            std::copy(other.m_data.get(), other.m_data.get() + m_size + 1,
-                      m_data.get());
+            m_data = data;
         }
         return *this;
     }
 
-    // Move assignment
-    String &operator=(String &&other) noexcept
+    // Move assignment; copies if the strings use different resources
+    String &operator=(String &&other)
     {
         if (this != &other) {
-            m_size = other.m_size;
-            m_data = std::move(other.m_data);
-            other.m_size = 0;
+            if (m_resource != other.m_resource && other.m_data) {
+                *this = static_cast<const String &>(other);
+                other.release();
+                other.m_size = 0;
+                return *this;
+            }
+            release();
+            m_size = std::exchange(other.m_size, 0);
+            m_data = std::exchange(other.m_data, nullptr);
         }
         return *this;
     }
 
-    ~String() = default; // Explicitly default it for Rule of 5/0 completeness
+    ~String() { release(); }
 
     // Accessors
     size_t size() const noexcept { return m_size; }
-    const char *c_str() const noexcept { return m_data.get(); }
+    const char *c_str() const noexcept { return m_data; }
+
+    // The memory resource, nullptr for the global heap
+    std::pmr::memory_resource *resource() const noexcept { return m_resource; }
 
     // Subscript operator (const)
     const char& operator[](size_t index) const
     {
         if (index >= m_size)
             throw std::out_of_range("String index out of range");
-        return m_data.get()[index];
+        return m_data[index];
     }
 
     // Subscript operator (non-const)
@@ -68,10 +85,29 @@ struct String {
     {
         if (index >= m_size)
             throw std::out_of_range("String index out of range");
-        return m_data.get()[index];
+        return m_data[index];
     }
 
   private:
+    char *allocate(size_t bytes)
+    {
+        if (m_resource)
+            return static_cast<char *>(m_resource->allocate(bytes, alignof(char)));
+        return new char[bytes];
+    }
+
+    void release() noexcept
+    {
+        if (!m_data)
+            return;
+        if (m_resource)
+            m_resource->deallocate(m_data, m_size + 1, alignof(char));
+        else
+            delete[] m_data;
+        m_data = nullptr;
+    }
+
     size_t m_size = 0;
-    std::unique_ptr<char[]> m_data;
+    std::pmr::memory_resource *m_resource = nullptr; // nullptr: global heap
+    char *m_data = nullptr;
 };
@@ -2,22 +2,52 @@
 
 #include <gtest/gtest.h>
 
-TEST(ArrayTest, DefaultConstructor)
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_aggregate_v<Array<int, 4>>);
+static_assert(std::is_trivially_copyable_v<Array<int, 4>>);
+static_assert(std::is_trivially_default_constructible_v<Array<int, 4>>);
+static_assert(std::is_trivially_copyable_v<Array<double, 8, 64>>);
+static_assert(!std::is_trivially_copyable_v<Array<std::string, 2>>);
+static_assert(alignof(Array<float, 16, 64>) == 64);
+
+TEST(ArrayTest, ValueInitialization)
 {
-    Array<int, 5> arr;
+    Array<int, 5> arr{};
     EXPECT_EQ(arr.size(), 5);
+    for (size_t i = 0; i < arr.size(); ++i) {
+        EXPECT_EQ(arr[i], 0);
+    }
 }
 
-TEST(ArrayTest, ValueInitializedConstructor)
+TEST(ArrayTest, Filled)
 {
-    Array<int, 4> arr(42);
+    auto arr = Array<int, 4>::filled(42);
     for (size_t i = 0; i < arr.size(); ++i) {
         EXPECT_EQ(arr[i], 42);
     }
+    arr.fill(3);
+    for (int x : arr) {
+        EXPECT_EQ(x, 3);
+    }
+}
+
+TEST(ArrayTest, AggregateInitialization)
+{
+    Array<int, 3> arr{1, 2, 3};
+    EXPECT_EQ(arr[0], 1);
+    EXPECT_EQ(arr[1], 2);
+    EXPECT_EQ(arr[2], 3);
+
+    Array<int, 3> partial{7};
+    EXPECT_EQ(partial[0], 7);
+    EXPECT_EQ(partial[2], 0);
 }
 TEST(ArrayTest, CopyConstructor)
 {
-    Array<int, 3> a(5);
+    auto a = Array<int, 3>::filled(5);
     Array<int, 3> b = a;
     for (size_t i = 0; i < b.size(); ++i) {
         EXPECT_EQ(b[i], 5);
@@ -25,7 +55,7 @@ TEST(ArrayTest, CopyConstructor)
 }
 TEST(ArrayTest, CopyAssignment)
 {
-    Array<int, 2> a(7);
+    auto a = Array<int, 2>::filled(7);
     Array<int, 2> b;
     b = a;
     for (size_t i = 0; i < b.size(); ++i) {
@@ -34,15 +64,15 @@ TEST(ArrayTest, CopyAssignment)
 }
 TEST(ArrayTest, MoveConstructor)
 {
-    Array<int, 3> a(9);
-    Array<int, 3> b = std::move(a);
+    auto a = Array<std::string, 3>::filled("nine");
+    Array<std::string, 3> b = std::move(a);
     for (size_t i = 0; i < b.size(); ++i) {
-        EXPECT_EQ(b[i], 9);
+        EXPECT_EQ(b[i], "nine");
     }
 }
 TEST(ArrayTest, MoveAssignment)
 {
-    Array<int, 4> a(11);
+    auto a = Array<int, 4>::filled(11);
     Array<int, 4> b;
     b = std::move(a);
     for (size_t i = 0; i < b.size(); ++i) {
@@ -51,27 +81,63 @@ TEST(ArrayTest, MoveAssignment)
 }
 TEST(ArrayTest, ElementAccess)
 {
-    Array<char, 3> arr('x');
+    auto arr = Array<char, 3>::filled('x');
     arr[0] = 'a';
     arr[1] = 'b';
-    arr[2] = 'c';
+    arr.at(2) = 'c';
     EXPECT_EQ(arr[0], 'a');
-    EXPECT_EQ(arr[1], 'b');
+    EXPECT_EQ(arr.at(1), 'b');
     EXPECT_EQ(arr[2], 'c');
 }
 TEST(ArrayTest, ConstAccess)
 {
-    const Array<char, 2> arr('z');
+    const auto arr = Array<char, 2>::filled('z');
     EXPECT_EQ(arr[0], 'z');
-    EXPECT_EQ(arr[1], 'z');
+    EXPECT_EQ(arr.at(1), 'z');
+    EXPECT_EQ(*arr.data(), 'z');
 }
 TEST(ArrayTest, Size)
 {
     Array<int, 10> arr;
     EXPECT_EQ(arr.size(), 10);
+    EXPECT_EQ(arr.end() - arr.begin(), 10);
 }
 TEST(ArrayTest, OutOfRange)
 {
-    Array<int, 2> arr(1);
-    EXPECT_THROW(arr[3], std::out_of_range); // Should not reach here
+    auto arr = Array<int, 2>::filled(1);
+    EXPECT_THROW(arr.at(3), std::out_of_range);
+    const auto &carr = arr;
+    EXPECT_THROW(carr.at(2), std::out_of_range);
+}
+
+TEST(ArrayTest, Alignment)
+{
+    Array<float, 5, 64> arr;
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arr.data()) % 64, 0u);
+}
+
+TEST(ArrayTest, ConstexprLookupTable)
+{
+    constexpr auto squares = [] {
+        Array<int, 16> table;
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = static_cast<int>(i * i);
+        }
+        return table;
+    }();
+    static_assert(squares[15] == 225);
+    static_assert(squares.at(3) == 9);
+
+    constexpr auto sevens = Array<int, 4>::filled(7);
+    static_assert(sevens[3] == 7);
+
+    constexpr int total = [] {
+        constexpr Array<int, 3> values{1, 2, 3};
+        int sum = 0;
+        for (int x : values) {
+            sum += x;
+        }
+        return sum;
+    }();
+    EXPECT_EQ(total, 6);
 }
@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <span>
+#include <string>
+#include <vector>
+
 TEST(CircularBufferTest, ParameterizedConstructor)
 {
     CircularBuffer buffer(4);
@@ -40,3 +44,97 @@ TEST(CircularBufferTest, Dequeue)
 }
 
 
+TEST(CircularBufferTest, CapacityRoundsUpToPowerOfTwo)
+{
+    CircularBuffer buffer(5);
+    EXPECT_EQ(buffer.capacity(), 8);
+
+    EXPECT_THROW(CircularBuffer(0), std::invalid_argument);
+}
+
+TEST(CircularBufferTest, OverwritesOldestWhenFull)
+{
+    CircularBuffer buffer(4);
+    for (int i = 0; i < 6; ++i) {
+        buffer.enqueue(i);
+    }
+
+    EXPECT_TRUE(buffer.isFull());
+    EXPECT_EQ(buffer.front(), 2);
+    EXPECT_EQ(buffer.back(), 5);
+    EXPECT_EQ(buffer.dequeue(), 2);
+}
+
+TEST(CircularBufferTest, GenericElementType)
+{
+    struct Sample {
+        double value = 0;
+        long timestamp = 0;
+    };
+
+    CircularBuffer<Sample> buffer(2);
+    buffer.enqueue(Sample{1.5, 10});
+    buffer.enqueue(Sample{2.5, 20});
+    buffer.enqueue(Sample{3.5, 30});
+
+    Sample oldest = buffer.dequeue();
+    EXPECT_EQ(oldest.value, 2.5);
+    EXPECT_EQ(oldest.timestamp, 20);
+
+    CircularBuffer<std::string> names(2);
+    names.enqueue(std::string("a"));
+    CircularBuffer<std::string> copy = names;
+    EXPECT_EQ(copy.dequeue(), "a");
+    EXPECT_EQ(names.size(), 1);
+}
+
+TEST(CircularBufferTest, PeekSpansAcrossWrap)
+{
+    CircularBuffer buffer(4);
+    for (int i = 0; i < 3; ++i) {
+        buffer.enqueue(i);
+    }
+    buffer.dequeue();
+    buffer.dequeue();
+    buffer.enqueue(3);
+    buffer.enqueue(4); // wraps: stored as [4, _, 2, 3]
+
+    auto [first, second] = buffer.peek_spans();
+    EXPECT_EQ(std::vector<int>(first.begin(), first.end()), (std::vector<int>{2, 3}));
+    EXPECT_EQ(std::vector<int>(second.begin(), second.end()), (std::vector<int>{4}));
+
+    buffer.consume(2);
+    auto [rest, none] = buffer.peek_spans();
+    EXPECT_EQ(rest.size(), 1);
+    EXPECT_EQ(rest[0], 4);
+    EXPECT_TRUE(none.empty());
+    EXPECT_THROW(buffer.consume(2), std::out_of_range);
+}
+
+TEST(CircularBufferTest, BulkEnqueueDequeue)
+{
+    CircularBuffer buffer(8);
+    buffer.enqueue(-1);
+    buffer.dequeue(); // start off zero so the bulk write wraps
+
+    std::vector<int> in{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    buffer.enqueue_bulk(std::span<const int>(in).first(6));
+    EXPECT_EQ(buffer.size(), 6);
+
+    buffer.enqueue_bulk(std::span<const int>(in).subspan(6)); // drops 0 and 1
+    EXPECT_EQ(buffer.size(), 8);
+    EXPECT_EQ(buffer.front(), 2);
+
+    std::vector<int> out(5);
+    EXPECT_EQ(buffer.dequeue_bulk(out), 5);
+    EXPECT_EQ(out, (std::vector<int>{2, 3, 4, 5, 6}));
+
+    EXPECT_EQ(buffer.dequeue_bulk(out), 3);
+    EXPECT_EQ(std::vector<int>(out.begin(), out.begin() + 3), (std::vector<int>{7, 8, 9}));
+    EXPECT_TRUE(buffer.isEmpty());
+
+    // more than the capacity: only the newest elements are kept
+    buffer.enqueue_bulk(in);
+    EXPECT_EQ(buffer.front(), 2);
+    EXPECT_EQ(buffer.back(), 9);
+}
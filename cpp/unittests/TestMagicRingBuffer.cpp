@@ -0,0 +1,112 @@
+#include "../stl/data-structure/MagicRingBuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+std::span<const std::byte> bytes_of(std::string_view text)
+{
+    return std::as_bytes(std::span<const char>(text.data(), text.size()));
+}
+
+std::string_view text_of(std::span<const std::byte> bytes)
+{
+    return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+} // namespace
+
+TEST(MagicRingBufferTest, CapacityIsAtLeastOnePage)
+{
+    MagicRingBuffer ring(100);
+    EXPECT_GE(ring.capacity(), static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+    EXPECT_EQ(ring.capacity() & (ring.capacity() - 1), 0u);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.write_region().size(), ring.capacity());
+
+    EXPECT_THROW(MagicRingBuffer(0), std::invalid_argument);
+}
+
+TEST(MagicRingBufferTest, RegionsStayContiguousAcrossWrap)
+{
+    MagicRingBuffer ring(1);
+    size_t capacity = ring.capacity();
+
+    // move the head close to the end of the buffer
+    std::vector<std::byte> filler(capacity - 3);
+    EXPECT_EQ(ring.write(filler), filler.size());
+    ring.consume(filler.size() - 1);
+
+    // the free space wraps, yet is one range
+    EXPECT_EQ(ring.write_region().size(), capacity - 1);
+    EXPECT_EQ(ring.write(bytes_of("hello, world")), 12u);
+
+    ring.consume(1);
+    EXPECT_EQ(text_of(ring.read_region()), "hello, world");
+
+    std::vector<std::byte> out(5);
+    EXPECT_EQ(ring.read(out), 5u);
+    EXPECT_EQ(text_of(out), "hello");
+    EXPECT_EQ(text_of(ring.read_region()), ", world");
+}
+
+TEST(MagicRingBufferTest, FillsToCapacity)
+{
+    MagicRingBuffer ring(1);
+    std::vector<std::byte> data(ring.capacity() + 10);
+    std::iota(reinterpret_cast<unsigned char *>(data.data()),
+              reinterpret_cast<unsigned char *>(data.data() + data.size()), 0);
+
+    EXPECT_EQ(ring.write(data), ring.capacity());
+    EXPECT_TRUE(ring.full());
+    EXPECT_TRUE(ring.write_region().empty());
+    EXPECT_THROW(ring.commit(1), std::out_of_range);
+    EXPECT_THROW(ring.consume(ring.capacity() + 1), std::out_of_range);
+
+    ring.consume(7);
+    auto region = ring.read_region();
+    EXPECT_EQ(region.size(), ring.capacity() - 7);
+    EXPECT_EQ(region[0], std::byte{7});
+}
+
+TEST(MagicRingBufferTest, SyscallsWriteIntoTheRing)
+{
+    MagicRingBuffer ring(1);
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::vector<std::byte> skip(ring.capacity() - 4);
+    ring.write(skip);
+    ring.consume(skip.size());
+
+    std::string_view message = "message that wraps";
+    ASSERT_EQ(::write(fds[1], message.data(), message.size()),
+              static_cast<ssize_t>(message.size()));
+
+    auto region = ring.write_region();
+    ssize_t got = ::read(fds[0], region.data(), region.size());
+    ASSERT_EQ(got, static_cast<ssize_t>(message.size()));
+    ring.commit(static_cast<size_t>(got));
+    EXPECT_EQ(text_of(ring.read_region()), message);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(MagicRingBufferTest, MoveTransfersTheMapping)
+{
+    MagicRingBuffer ring(1);
+    ring.write(bytes_of("abc"));
+
+    MagicRingBuffer moved(std::move(ring));
+    EXPECT_EQ(text_of(moved.read_region()), "abc");
+
+    MagicRingBuffer other(1);
+    other = std::move(moved);
+    EXPECT_EQ(text_of(other.read_region()), "abc");
+}
@@ -0,0 +1,159 @@
+#include "../stl/data-structure/MonotonicArena.h"
+#include "../stl/data-structure/Queue.h"
+#include "../stl/data-structure/Vector.h"
+#include "../stl/data-types/String.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+
+namespace
+{
+// Forwards to the global heap and counts what is still outstanding
+class CountingResource : public std::pmr::memory_resource
+{
+  public:
+    int allocations = 0;
+    int outstanding = 0;
+
+  private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        ++allocations;
+        ++outstanding;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        --outstanding;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+} // namespace
+
+TEST(MonotonicArenaTest, BumpAllocatesAligned)
+{
+    MonotonicArena arena(1024);
+    void *a = arena.allocate(3, 1);
+    void *b = arena.allocate(8, 8);
+    void *c = arena.allocate(64, 64);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 8, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0u);
+    EXPECT_LT(a, b);
+    EXPECT_LT(b, c);
+    EXPECT_GE(arena.used(), 3u + 8 + 64);
+
+    EXPECT_THROW(MonotonicArena(0), std::invalid_argument);
+}
+
+TEST(MonotonicArenaTest, ResetReusesChunks)
+{
+    CountingResource upstream;
+    MonotonicArena arena(256, &upstream);
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 20; ++i) {
+            (void)arena.allocate(100, 8); // needs several chunks
+        }
+        arena.reset();
+        EXPECT_EQ(arena.used(), 0u);
+    }
+    int after_first_rounds = upstream.allocations;
+    EXPECT_GT(after_first_rounds, 1);
+
+    for (int i = 0; i < 20; ++i) {
+        (void)arena.allocate(100, 8);
+    }
+    EXPECT_EQ(upstream.allocations, after_first_rounds);
+
+    (void)arena.allocate(10'000, 8); // larger than any chunk
+    EXPECT_EQ(upstream.allocations, after_first_rounds + 1);
+    EXPECT_GE(arena.reserved(), 10'000u);
+}
+
+TEST(MonotonicArenaTest, ReleasesChunksUpstream)
+{
+    CountingResource upstream;
+    {
+        MonotonicArena arena(64, &upstream);
+        (void)arena.allocate(1000, 16);
+        (void)arena.allocate(1000, 16);
+        EXPECT_GT(upstream.outstanding, 0);
+    }
+    EXPECT_EQ(upstream.outstanding, 0);
+}
+
+TEST(MonotonicArenaTest, ContainersAllocateFromResource)
+{
+    CountingResource resource;
+    {
+        Vector<std::string> vector(&resource);
+        for (int i = 0; i < 10; ++i) {
+            vector.push_back(std::to_string(i));
+        }
+        Vector<int> ints(&resource);
+        for (int i = 0; i < 100; ++i) {
+            ints.push_back(i); // trivially relocatable, but not via realloc here
+        }
+        EXPECT_EQ(ints[99], 99);
+
+        Queue<int> queue(&resource);
+        for (int i = 0; i < 200; ++i) {
+            queue.push(i);
+        }
+
+        String string("request body", &resource);
+        EXPECT_STREQ(string.c_str(), "request body");
+        EXPECT_EQ(string.resource(), &resource);
+
+        EXPECT_GT(resource.allocations, 0);
+        EXPECT_EQ(vector[9], "9");
+        EXPECT_EQ(queue.back(), 199);
+    }
+    EXPECT_EQ(resource.outstanding, 0);
+}
+
+TEST(MonotonicArenaTest, MovesKeepOrConvertResource)
+{
+    MonotonicArena arena;
+
+    Vector<int> on_arena(&arena);
+    on_arena.push_back(1);
+    Vector<int> moved(std::move(on_arena));
+    EXPECT_EQ(moved.resource(), &arena);
+
+    Vector<int> on_heap;
+    on_heap = std::move(moved); // different resource: elements are moved over
+    EXPECT_EQ(on_heap.resource(), nullptr);
+    EXPECT_EQ(on_heap[0], 1);
+    EXPECT_TRUE(moved.empty());
+
+    Vector<int> copy(on_heap, &arena);
+    EXPECT_EQ(copy.resource(), &arena);
+    EXPECT_EQ(copy[0], 1);
+
+    Queue<int> heap_queue{1, 2, 3};
+    Queue<int> arena_queue(&arena);
+    arena_queue.push(0);
+    arena_queue.splice(heap_queue); // element by element
+    EXPECT_EQ(arena_queue, (Queue<int>{0, 1, 2, 3}));
+    EXPECT_TRUE(heap_queue.empty());
+    Queue<int> front = arena_queue.split_front(2);
+    EXPECT_EQ(front.resource(), &arena);
+
+    String heap_string("text");
+    String arena_string("", &arena);
+    arena_string = std::move(heap_string);
+    EXPECT_STREQ(arena_string.c_str(), "text");
+    EXPECT_EQ(arena_string.resource(), &arena);
+    EXPECT_EQ(heap_string.c_str(), nullptr);
+}
@@ -0,0 +1,97 @@
+#include "../concurrency/numa_threadpool.h"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+static void write_file(const fs::path &path, const std::string &content)
+{
+    fs::create_directories(path.parent_path());
+    std::ofstream(path) << content << '\n';
+}
+
+TEST(NumaThreadPoolTest, ParseCpuList)
+{
+    EXPECT_EQ(parse_cpu_list("0-3,8,10-11"),
+              (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(parse_cpu_list("5"), (std::vector<int>{5}));
+    EXPECT_TRUE(parse_cpu_list("").empty());
+}
+
+TEST(NumaThreadPoolTest, DetectReadsSysfsLayout)
+{
+    fs::path root = fs::temp_directory_path() / "numa_topology_test";
+    fs::remove_all(root);
+    write_file(root / "online", "0-2");
+    write_file(root / "node0/cpulist", "0-1");
+    write_file(root / "node0/distance", "10 21 31");
+    write_file(root / "node1/cpulist", "2-3");
+    write_file(root / "node1/distance", "21 10 31");
+    write_file(root / "node2/cpulist", "4");
+    write_file(root / "node2/distance", "31 31 10");
+
+    auto topology = NumaTopology::detect(root.string());
+    fs::remove_all(root);
+
+    ASSERT_EQ(topology.nodes(), 3);
+    EXPECT_EQ(topology.cpus[1], (std::vector<int>{2, 3}));
+    EXPECT_EQ(topology.distance[2][0], 31);
+    EXPECT_EQ(topology.node_of_cpu(4), 2);
+    EXPECT_EQ(topology.node_of_cpu(7), 3);
+}
+
+TEST(NumaThreadPoolTest, DetectFallsBackToSingleNode)
+{
+    auto topology = NumaTopology::detect("/nonexistent/numa/root");
+    ASSERT_EQ(topology.nodes(), 1);
+    EXPECT_FALSE(topology.cpus[0].empty());
+}
+
+TEST(NumaThreadPoolTest, SubmitRunsOnLocalNode)
+{
+    NumaThreadPool pool(1, NumaTopology{{{0}}, {}});
+    EXPECT_EQ(pool.nodes(), 1);
+    EXPECT_EQ(pool.submit([] { return 7; }).get(), 7);
+    EXPECT_EQ(pool.submit_on(0, [] { return 8; }).get(), 8);
+    EXPECT_THROW(pool.node_pool(1), std::out_of_range);
+}
+
+TEST(NumaThreadPoolTest, IdleNodeStealsFromBusyNode)
+{
+    // two "nodes" sharing cpu 0 so the test runs on any machine
+    NumaThreadPool pool(1, NumaTopology{{{0}, {0}}, {}});
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> started;
+    pool.submit_on(0, [&started, released] {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+
+    // node 0's only worker is blocked; node 1 must pick this up
+    auto stolen = pool.submit_on(0, [] { return 42; });
+    EXPECT_EQ(stolen.get(), 42);
+    release.set_value();
+}
+
+TEST(ThreadPoolTest, PinnedWorkersRunTasks)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 2;
+    options.cpuSet = {0};
+    options.pinOnePerCpu = true;
+    ThreadPool pool(options);
+    EXPECT_EQ(pool.submit([] { return sched_getcpu(); }).get(), 0);
+}
+
+TEST(ThreadPoolTest, InvalidCpuThrows)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.cpuSet = {-1};
+    EXPECT_THROW(ThreadPool pool(options), std::invalid_argument);
+}
@@ -0,0 +1,101 @@
+#include "../concurrency/parallel.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+#include <vector>
+
+TEST(ParallelTest, ForVisitsEveryIndexOnce)
+{
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(10000);
+    parallel_for(pool, 0, 10000, [&hits](int i) { ++hits[i]; });
+
+    for (const auto &hit : hits)
+        EXPECT_EQ(hit.load(), 1);
+}
+
+TEST(ParallelTest, ForEmptyRangeDoesNothing)
+{
+    ThreadPool pool(2);
+    int calls = 0;
+    parallel_for(pool, 5, 5, [&calls](int) { ++calls; });
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(ParallelTest, ForPropagatesException)
+{
+    ThreadPool pool(4);
+    EXPECT_THROW(parallel_for(pool, 0, 1000,
+                              [](int i) {
+                                  if (i == 777)
+                                      throw std::runtime_error("bad index");
+                              },
+                              1),
+                 std::runtime_error);
+}
+
+TEST(ParallelTest, ReduceMatchesAccumulate)
+{
+    ThreadPool pool(4);
+    std::vector<long long> v(100000);
+    std::iota(v.begin(), v.end(), 1);
+
+    auto sum = parallel_reduce(pool, v.begin(), v.end(), 0LL, std::plus<>());
+    EXPECT_EQ(sum, std::accumulate(v.begin(), v.end(), 0LL));
+    EXPECT_EQ(parallel_reduce(pool, v.begin(), v.begin(), 7LL, std::plus<>()), 7);
+}
+
+TEST(ParallelTest, ReduceKeepsOrderForNonCommutativeOp)
+{
+    ThreadPool pool(4);
+    std::vector<std::string> words;
+    std::string expected;
+    for (int i = 0; i < 2000; ++i) {
+        words.push_back(std::to_string(i % 10));
+        expected += words.back();
+    }
+
+    auto joined = parallel_reduce(pool, words.begin(), words.end(), std::string(),
+                                  std::plus<>(), 16);
+    EXPECT_EQ(joined, expected);
+}
+
+TEST(ParallelTest, NestedCallsFromPoolTask)
+{
+    ThreadPool pool(2);
+    std::vector<int> v(5000, 1);
+    auto outer = pool.submit([&pool, &v] {
+        return parallel_reduce(pool, v.begin(), v.end(), 0, std::plus<>());
+    });
+    EXPECT_EQ(outer.get(), 5000);
+}
+
+TEST(ParallelTest, ScanMatchesInclusiveScan)
+{
+    ThreadPool pool(4);
+    std::vector<int> v(12345);
+    std::iota(v.begin(), v.end(), 0);
+    std::vector<int> expected(v.size());
+    std::vector<int> actual(v.size());
+
+    std::partial_sum(v.begin(), v.end(), expected.begin());
+    auto end = parallel_scan(pool, v.begin(), v.end(), actual.begin(), 0, std::plus<>());
+
+    EXPECT_EQ(end, actual.end());
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(ParallelTest, ScanWithSmallGrainKeepsOrder)
+{
+    ThreadPool pool(3);
+    std::vector<std::string> v;
+    for (int i = 0; i < 300; ++i)
+        v.push_back(std::string(1, char('a' + i % 26)));
+    std::vector<std::string> expected(v.size());
+    std::vector<std::string> actual(v.size());
+
+    std::partial_sum(v.begin(), v.end(), expected.begin());
+    parallel_scan(pool, v.begin(), v.end(), actual.begin(), std::string(), std::plus<>(), 8);
+    EXPECT_EQ(actual, expected);
+}
@@ -88,3 +88,93 @@ TEST_F(QueueTest, MoveAssignmentTransfersOwnership)
     EXPECT_TRUE(int_queue.empty());
     EXPECT_FALSE(other.empty());
 }
+
+TEST_F(QueueTest, SpliceAppendsAndEmptiesOther)
+{
+    Queue<int> other{3, 4};
+    int_queue.push(1);
+    int_queue.push(2);
+    int_queue.splice(other);
+
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(int_queue, (Queue<int>{1, 2, 3, 4}));
+    int_queue.push(5);
+    EXPECT_EQ(int_queue.back(), 5);
+
+    Queue<int> empty;
+    empty.splice(int_queue);
+    EXPECT_EQ(empty.size(), 5);
+    EXPECT_TRUE(int_queue.empty());
+}
+
+TEST_F(QueueTest, SplitFrontDetachesPrefix)
+{
+    Queue<int> q{1, 2, 3, 4, 5};
+    Queue<int> front = q.split_front(2);
+    EXPECT_EQ(front, (Queue<int>{1, 2}));
+    EXPECT_EQ(q, (Queue<int>{3, 4, 5}));
+    front.push(9);
+    EXPECT_EQ(front.back(), 9);
+
+    Queue<int> rest = q.split_front(10);
+    EXPECT_EQ(rest, (Queue<int>{3, 4, 5}));
+    EXPECT_TRUE(q.empty());
+    EXPECT_TRUE(q.split_front(1).empty());
+}
+
+TEST_F(QueueTest, ManyElementsAcrossBlocks)
+{
+    for (int i = 0; i < 1000; ++i)
+        str_queue.push(std::to_string(i));
+    Queue<std::string> copy = str_queue;
+    EXPECT_EQ(copy, str_queue);
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(str_queue.front(), std::to_string(i));
+        str_queue.pop();
+        // steady state push/pop reuses the emptied blocks
+        if (i % 3 == 0)
+            str_queue.push("x");
+    }
+    EXPECT_EQ(str_queue.size(), 334);
+    EXPECT_NE(copy, str_queue);
+}
+
+TEST_F(QueueTest, EqualityWithDifferentBlockOffsets)
+{
+    Queue<int> a, b;
+    for (int i = 0; i < 200; ++i)
+        a.push(i);
+    for (int i = 0; i < 37; ++i)
+        a.pop();
+    for (int i = 37; i < 200; ++i)
+        b.push(i);
+    EXPECT_EQ(a, b);
+
+    b.back() = -1;
+    EXPECT_NE(a, b);
+}
+
+TEST_F(QueueTest, SplitFrontInsideALaterBlock)
+{
+    Queue<std::string> q;
+    for (int i = 0; i < 300; ++i)
+        q.push(std::to_string(i));
+    q.pop();
+
+    Queue<std::string> front = q.split_front(150);
+    ASSERT_EQ(front.size(), 150);
+    ASSERT_EQ(q.size(), 149);
+    for (int i = 1; i <= 150; ++i) {
+        EXPECT_EQ(front.front(), std::to_string(i));
+        front.pop();
+    }
+    EXPECT_EQ(q.front(), "151");
+    EXPECT_EQ(q.back(), "299");
+
+    Queue<std::string> tail{"a", "b"};
+    q.splice(tail);
+    q.push("c");
+    EXPECT_EQ(q.size(), 152);
+    EXPECT_EQ(q.back(), "c");
+}
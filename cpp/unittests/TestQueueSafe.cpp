@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <gtest/gtest.h>
+#include <numeric>
 #include <thread>
 #include <vector>
 
@@ -75,3 +76,194 @@ TEST(QueueSafeTest, MultipleThreadedPushPop)
         EXPECT_EQ(results[i], i);
     }
 }
+
+TEST(QueueSafeTest, SpinningConsumerPingPong)
+{
+    QueueSafe<int> ping(SpinPolicy{1 << 16, 64});
+    QueueSafe<int> pong(SpinPolicy{1 << 16, 64});
+    const int rounds = 500;
+
+    std::thread echo([&]() {
+        for (int i = 0; i < rounds; ++i)
+            pong.push(ping.pop() + 1);
+    });
+
+    int value = 0;
+    for (int i = 0; i < rounds; ++i) {
+        ping.push(value);
+        value = pong.pop();
+    }
+    echo.join();
+    EXPECT_EQ(value, rounds);
+}
+
+TEST(QueueSafeTest, PushBulkAndPopBulk)
+{
+    QueueSafe<int> q;
+    std::vector<int> values(100);
+    std::iota(values.begin(), values.end(), 0);
+    q.push_bulk(values);
+
+    Queue<int> batch = q.pop_bulk(30);
+    EXPECT_EQ(batch.size(), 30);
+    EXPECT_EQ(batch.front(), 0);
+    EXPECT_EQ(batch.back(), 29);
+
+    batch = q.pop_bulk(1000);
+    EXPECT_EQ(batch.size(), 70);
+    EXPECT_EQ(batch.front(), 30);
+
+    // an empty result means closed and drained, never "asked for none"
+    q.push(1);
+    EXPECT_THROW(q.pop_bulk(0), std::invalid_argument);
+    EXPECT_EQ(q.size(), 1);
+}
+
+TEST(QueueSafeTest, PushBulkWakesBlockedConsumers)
+{
+    QueueSafe<int> q;
+    std::atomic<int> sum{0};
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 4; ++i)
+        consumers.emplace_back([&]() { sum += q.pop(); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.push_bulk(std::vector<int>{1, 2, 3, 4});
+    for (auto &consumer : consumers)
+        consumer.join();
+    EXPECT_EQ(sum, 10);
+}
+
+TEST(QueueSafeTest, TryPopDoesNotBlock)
+{
+    QueueSafe<int> q;
+    EXPECT_FALSE(q.try_pop().has_value());
+    q.push(7);
+    EXPECT_EQ(q.try_pop(), 7);
+    EXPECT_FALSE(q.try_pop().has_value());
+}
+
+TEST(QueueSafeTest, PopForTimesOut)
+{
+    QueueSafe<int> q;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(q.pop_for(std::chrono::milliseconds(20)).has_value());
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        q.push(3);
+    });
+    EXPECT_EQ(q.pop_until(std::chrono::steady_clock::now() + std::chrono::seconds(5)), 3);
+    producer.join();
+}
+
+TEST(QueueSafeTest, CloseWakesWaitersAndDrains)
+{
+    QueueSafe<int> q;
+    std::atomic<int> woken{0};
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 3; ++i) {
+        consumers.emplace_back([&]() {
+            EXPECT_THROW(q.pop(), QueueClosed);
+            ++woken;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.close();
+    for (auto &consumer : consumers)
+        consumer.join();
+    EXPECT_EQ(woken, 3);
+    EXPECT_TRUE(q.closed());
+    EXPECT_THROW(q.push(1), QueueClosed);
+}
+
+TEST(QueueSafeTest, ClosedQueueStillDeliversQueuedElements)
+{
+    QueueSafe<int> q;
+    q.push(1);
+    q.push(2);
+    q.close();
+
+    EXPECT_EQ(q.pop(), 1);
+    EXPECT_EQ(q.pop_for(std::chrono::seconds(5)), 2);
+    EXPECT_FALSE(q.pop_for(std::chrono::seconds(5)).has_value());
+    EXPECT_TRUE(q.pop_bulk(10).empty());
+    EXPECT_THROW(q.pop(), QueueClosed);
+}
+
+TEST(QueueSafeTest, BoundedBlockWaitsForRoom)
+{
+    QueueSafe<int> q(2, OverflowPolicy::Block);
+    q.push(1);
+    q.push(2);
+
+    std::atomic<bool> pushed{false};
+    std::thread producer([&]() {
+        q.push(3);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed);
+
+    EXPECT_EQ(q.pop(), 1);
+    producer.join();
+    EXPECT_TRUE(pushed);
+    EXPECT_EQ(q.size(), 2);
+}
+
+TEST(QueueSafeTest, BoundedDropPolicies)
+{
+    QueueSafe<int> newest(2, OverflowPolicy::DropNewest);
+    EXPECT_TRUE(newest.push(1));
+    EXPECT_TRUE(newest.push(2));
+    EXPECT_FALSE(newest.push(3));
+    EXPECT_EQ(newest.push_bulk(std::vector<int>{4, 5}), 0);
+    EXPECT_EQ(newest.dropped(), 3);
+    EXPECT_EQ(newest.pop(), 1);
+
+    QueueSafe<int> oldest(2, OverflowPolicy::DropOldest);
+    oldest.push(1);
+    oldest.push(2);
+    EXPECT_TRUE(oldest.push(3));
+    EXPECT_EQ(oldest.pop(), 2);
+    EXPECT_EQ(oldest.push_bulk(std::vector<int>{4, 5, 6}), 2);
+    EXPECT_EQ(oldest.dropped(), 3);
+    EXPECT_EQ(oldest.pop(), 5);
+    EXPECT_EQ(oldest.pop(), 6);
+}
+
+TEST(QueueSafeTest, BoundedFailThrows)
+{
+    QueueSafe<int> q(1, OverflowPolicy::Fail);
+    q.push(1);
+    EXPECT_THROW(q.push(2), QueueFull);
+    EXPECT_THROW(q.push_bulk(std::vector<int>{2, 3}), QueueFull);
+    EXPECT_EQ(q.size(), 1);
+    EXPECT_THROW(QueueSafe<int>(0), std::invalid_argument);
+}
+
+TEST(QueueSafeTest, BoundedPushBulkBlocksPiecewise)
+{
+    QueueSafe<int> q(4);
+    std::vector<int> values(100);
+    std::iota(values.begin(), values.end(), 0);
+    std::thread producer([&]() { EXPECT_EQ(q.push_bulk(values), 100); });
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_LE(q.size(), 4);
+        EXPECT_EQ(q.pop(), i);
+    }
+    producer.join();
+}
+
+TEST(QueueSafeTest, CloseWakesBlockedProducer)
+{
+    QueueSafe<int> q(1);
+    q.push(1);
+    std::thread producer([&]() { EXPECT_THROW(q.push(2), QueueClosed); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.close();
+    producer.join();
+    EXPECT_EQ(q.pop(), 1);
+}
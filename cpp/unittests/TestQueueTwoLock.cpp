@@ -0,0 +1,101 @@
+#include "../stl/data-structure/QueueTwoLock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(QueueTwoLockTest, FifoOrder)
+{
+    QueueTwoLock<std::string> q;
+    EXPECT_TRUE(q.empty());
+    EXPECT_FALSE(q.try_pop().has_value());
+
+    q.push("a");
+    q.push(std::string("b"));
+    q.emplace(3, 'c');
+    EXPECT_FALSE(q.empty());
+    EXPECT_EQ(q.pop(), "a");
+    EXPECT_EQ(q.try_pop(), "b");
+
+    std::string value;
+    EXPECT_TRUE(q.try_pop(value));
+    EXPECT_EQ(value, "ccc");
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(QueueTwoLockTest, DestroysRemainingElements)
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        QueueTwoLock<std::shared_ptr<int>> q;
+        q.push(tracker);
+        q.push(tracker);
+        q.try_pop();
+        q.push(tracker); // reuses the popped node
+        EXPECT_EQ(tracker.use_count(), 3);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(QueueTwoLockTest, BlockingPopWaitsUntilPush)
+{
+    QueueTwoLock<int> q;
+    std::atomic<bool> popped{false};
+    std::thread consumer([&]() {
+        EXPECT_EQ(q.pop(), 42);
+        popped = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(popped);
+    q.push(42);
+    consumer.join();
+    EXPECT_TRUE(popped);
+}
+
+TEST(QueueTwoLockTest, ManyProducersAndConsumers)
+{
+    QueueTwoLock<int> q;
+    const int producers = 4, consumers = 4, perProducer = 5000;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<int>> seen(consumers);
+
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < perProducer; ++i)
+                q.push(p * perProducer + i);
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            for (int i = 0; i < producers * perProducer / consumers; ++i)
+                seen[c].push_back(q.pop());
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    std::vector<int> all;
+    for (auto &values : seen) {
+        // every consumer sees each producer's values in push order
+        for (int p = 0; p < producers; ++p) {
+            int last = -1;
+            for (int v : values) {
+                if (v / perProducer == p) {
+                    EXPECT_GT(v, last);
+                    last = v;
+                }
+            }
+        }
+        all.insert(all.end(), values.begin(), values.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), size_t(producers * perProducer));
+    for (int i = 0; i < producers * perProducer; ++i)
+        EXPECT_EQ(all[i], i);
+    EXPECT_TRUE(q.empty());
+}
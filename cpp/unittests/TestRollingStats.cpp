@@ -0,0 +1,137 @@
+#include "../stl/data-structure/RollingStats.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Reference statistics over the last `window` values of xs
+RollingStats::Summary naive(const std::vector<double> &xs, size_t window)
+{
+    std::vector<double> w(xs.end() - std::min(window, xs.size()), xs.end());
+    RollingStats::Summary s;
+    s.count = w.size();
+    s.sum = std::accumulate(w.begin(), w.end(), 0.0);
+    s.mean = s.sum / s.count;
+    for (double x : w) {
+        s.variance += (x - s.mean) * (x - s.mean);
+    }
+    s.variance /= s.count;
+    s.min = *std::min_element(w.begin(), w.end());
+    s.max = *std::max_element(w.begin(), w.end());
+    return s;
+}
+} // namespace
+
+TEST(RollingStatsTest, EmptyWindow)
+{
+    EXPECT_THROW(RollingStats(0), std::invalid_argument);
+
+    RollingStats stats(4);
+    EXPECT_TRUE(stats.empty());
+    EXPECT_THROW(stats.mean(), std::out_of_range);
+    EXPECT_THROW(stats.min(), std::out_of_range);
+    EXPECT_EQ(stats.summary().count, 0);
+}
+
+TEST(RollingStatsTest, SlidingWindow)
+{
+    RollingStats stats(3);
+    stats.push(1);
+    stats.push(5);
+    stats.push(3);
+    EXPECT_EQ(stats.count(), 3);
+    EXPECT_DOUBLE_EQ(stats.mean(), 3);
+    EXPECT_EQ(stats.min(), 1);
+    EXPECT_EQ(stats.max(), 5);
+
+    stats.push(2); // 1 leaves
+    EXPECT_EQ(stats.count(), 3);
+    EXPECT_DOUBLE_EQ(stats.sum(), 10);
+    EXPECT_EQ(stats.min(), 2);
+    EXPECT_EQ(stats.max(), 5);
+
+    stats.push(0); // 5 leaves
+    EXPECT_EQ(stats.min(), 0);
+    EXPECT_EQ(stats.max(), 3);
+    EXPECT_DOUBLE_EQ(stats.variance(), 14.0 / 9);
+}
+
+TEST(RollingStatsTest, MatchesNaiveRecomputation)
+{
+    std::mt19937 rng(7);
+    std::normal_distribution<double> dist(100, 15);
+    // window not a power of two, so the buffer wraps at a different point
+    const size_t window = 100;
+    RollingStats stats(window);
+    std::vector<double> xs;
+
+    for (int i = 0; i < 1000; ++i) {
+        xs.push_back(dist(rng));
+        stats.push(xs.back());
+
+        auto expected = naive(xs, window);
+        ASSERT_EQ(stats.count(), expected.count);
+        ASSERT_NEAR(stats.mean(), expected.mean, 1e-9);
+        ASSERT_NEAR(stats.variance(), expected.variance, 1e-6);
+        ASSERT_EQ(stats.min(), expected.min);
+        ASSERT_EQ(stats.max(), expected.max);
+
+        auto summary = stats.summary();
+        ASSERT_NEAR(summary.sum, expected.sum, 1e-7);
+        ASSERT_NEAR(summary.variance, expected.variance, 1e-6);
+        ASSERT_EQ(summary.min, expected.min);
+        ASSERT_EQ(summary.max, expected.max);
+    }
+}
+
+TEST(RollingStatsTest, Percentile)
+{
+    RollingStats stats(10);
+    for (int i = 1; i <= 15; ++i) {
+        stats.push(i); // window holds 6..15
+    }
+    EXPECT_EQ(stats.percentile(0), 6);
+    EXPECT_EQ(stats.percentile(50), 10);
+    EXPECT_EQ(stats.percentile(90), 14);
+    EXPECT_EQ(stats.percentile(100), 15);
+    EXPECT_THROW(stats.percentile(101), std::out_of_range);
+}
+
+TEST(RollingStatsTest, ClearAndRefill)
+{
+    RollingStats stats(2);
+    stats.push_bulk(std::vector<double>{4, 8, 9});
+    stats.clear();
+    EXPECT_TRUE(stats.empty());
+
+    stats.push(1);
+    EXPECT_EQ(stats.min(), 1);
+    EXPECT_EQ(stats.max(), 1);
+    EXPECT_DOUBLE_EQ(stats.sum(), 1);
+}
+
+TEST(RollingStatsTest, KernelsAgreeWithScalar)
+{
+    std::vector<double> xs(1003);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> dist(-50, 50);
+    for (double &x : xs) {
+        x = dist(rng);
+    }
+
+    for (size_t n : {0, 1, 3, 4, 7, 8, 9, 1003}) {
+        std::span<const double> part(xs.data(), n);
+        auto scalar = rolling_detail::moments_scalar(part);
+        auto dispatched = rolling_detail::moments(part);
+        EXPECT_NEAR(dispatched.sum, scalar.sum, 1e-9);
+        EXPECT_NEAR(dispatched.sum_sq, scalar.sum_sq, 1e-6);
+        if (n > 0) {
+            EXPECT_EQ(rolling_detail::minmax(part), rolling_detail::minmax_scalar(part));
+        }
+    }
+}
@@ -0,0 +1,162 @@
+#include "../stl/data-structure/Array.h"
+#include "../stl/data-structure/SimdAlgorithms.h"
+#include "../stl/data-structure/Vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+const simd::Isa all_isas[] = {simd::Isa::Scalar, simd::Isa::SSE42, simd::Isa::AVX2,
+                              simd::Isa::AVX512};
+
+// Restores the detected instruction set when a test ends
+struct IsaGuard {
+    ~IsaGuard() { simd::force_isa(simd::detected_isa()); }
+};
+
+template <typename T> std::vector<T> random_values(size_t n, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(-50, 50);
+    std::vector<T> xs(n);
+    for (T &x : xs) {
+        x = static_cast<T>(dist(gen));
+    }
+    return xs;
+}
+} // namespace
+
+TEST(SimdAlgorithmsTest, ForceIsaClampsToDetected)
+{
+    IsaGuard guard;
+    EXPECT_EQ(simd::force_isa(simd::Isa::Scalar), simd::Isa::Scalar);
+    EXPECT_EQ(simd::active_isa(), simd::Isa::Scalar);
+    EXPECT_EQ(simd::force_isa(simd::Isa::AVX512), simd::detected_isa());
+    EXPECT_EQ(simd::active_isa(), simd::detected_isa());
+}
+
+// Every size from 0 to 200 covers the empty span, spans shorter than one
+// step and every tail length at each vector width
+TEST(SimdAlgorithmsTest, IntMatchesScalarOnEveryIsa)
+{
+    IsaGuard guard;
+    for (simd::Isa isa : all_isas) {
+        simd::force_isa(isa);
+        for (size_t n = 0; n <= 200; ++n) {
+            std::vector<int32_t> a = random_values<int32_t>(n, static_cast<unsigned>(n));
+            std::vector<int32_t> b = random_values<int32_t>(n, static_cast<unsigned>(n + 1000));
+            std::span<const int32_t> xs(a), ys(b);
+
+            int64_t expected_dot = 0;
+            for (size_t i = 0; i < n; ++i) {
+                expected_dot += int64_t{a[i]} * b[i];
+            }
+            for (int32_t needle : {-50, 0, 7, 99}) {
+                EXPECT_EQ(simd::find(xs, needle),
+                          std::find(a.begin(), a.end(), needle) - a.begin());
+                EXPECT_EQ(simd::count(xs, needle),
+                          static_cast<size_t>(std::count(a.begin(), a.end(), needle)));
+            }
+            EXPECT_EQ(simd::sum(xs), std::accumulate(a.begin(), a.end(), int64_t{0}));
+            EXPECT_EQ(simd::dot(xs, ys), expected_dot);
+            if (n > 0) {
+                EXPECT_EQ(simd::min(xs), *std::min_element(a.begin(), a.end()));
+                EXPECT_EQ(simd::max(xs), *std::max_element(a.begin(), a.end()));
+            }
+        }
+    }
+}
+
+// Small integers keep float sums exact in any order
+TEST(SimdAlgorithmsTest, FloatMatchesScalarOnEveryIsa)
+{
+    IsaGuard guard;
+    for (simd::Isa isa : all_isas) {
+        simd::force_isa(isa);
+        for (size_t n = 0; n <= 200; ++n) {
+            std::vector<float> a = random_values<float>(n, static_cast<unsigned>(n));
+            std::vector<float> b = random_values<float>(n, static_cast<unsigned>(n + 1000));
+            std::span<const float> xs(a), ys(b);
+
+            float expected_dot = 0;
+            for (size_t i = 0; i < n; ++i) {
+                expected_dot += a[i] * b[i];
+            }
+            EXPECT_EQ(simd::find(xs, 7.0f), std::find(a.begin(), a.end(), 7.0f) - a.begin());
+            EXPECT_EQ(simd::count(xs, 7.0f),
+                      static_cast<size_t>(std::count(a.begin(), a.end(), 7.0f)));
+            EXPECT_EQ(simd::sum(xs), std::accumulate(a.begin(), a.end(), 0.0f));
+            EXPECT_EQ(simd::dot(xs, ys), expected_dot);
+            if (n > 0) {
+                EXPECT_EQ(simd::min(xs), *std::min_element(a.begin(), a.end()));
+                EXPECT_EQ(simd::max(xs), *std::max_element(a.begin(), a.end()));
+            }
+        }
+    }
+}
+
+TEST(SimdAlgorithmsTest, FindReturnsFirstMatch)
+{
+    IsaGuard guard;
+    std::vector<int32_t> xs(100, 0);
+    xs[40] = 1;
+    xs[70] = 1;
+    for (simd::Isa isa : all_isas) {
+        simd::force_isa(isa);
+        EXPECT_EQ(simd::find(std::span<const int32_t>(xs), 1), 40u);
+    }
+}
+
+TEST(SimdAlgorithmsTest, SumDoesNotOverflow)
+{
+    IsaGuard guard;
+    std::vector<int32_t> xs(1000, INT32_MAX), ys(1000, 1 << 20);
+    for (simd::Isa isa : all_isas) {
+        simd::force_isa(isa);
+        EXPECT_EQ(simd::sum(std::span<const int32_t>(xs)), int64_t{INT32_MAX} * 1000);
+        EXPECT_EQ(simd::dot(std::span<const int32_t>(ys), std::span<const int32_t>(ys)),
+                  (int64_t{1} << 40) * 1000);
+    }
+}
+
+TEST(SimdAlgorithmsTest, InvalidArguments)
+{
+    std::span<const int32_t> empty;
+    EXPECT_THROW(simd::min(empty), std::invalid_argument);
+    EXPECT_THROW(simd::max(empty), std::invalid_argument);
+    EXPECT_EQ(simd::find(empty, 1), 0u);
+    EXPECT_EQ(simd::sum(empty), 0);
+
+    std::vector<float> a(4), b(5);
+    EXPECT_THROW(simd::dot(std::span<const float>(a), std::span<const float>(b)),
+                 std::invalid_argument);
+}
+
+TEST(SimdAlgorithmsTest, OverVector)
+{
+    Vector<int32_t> vec;
+    for (int32_t i = 1; i <= 100; ++i) {
+        vec.push_back(i);
+    }
+    std::span<const int32_t> xs(vec.data(), vec.size());
+    EXPECT_EQ(simd::sum(xs), 5050);
+    EXPECT_EQ(simd::max(xs), 100);
+    EXPECT_EQ(simd::find(xs, 42), 41u);
+}
+
+TEST(SimdAlgorithmsTest, OverArray)
+{
+    Array<float, 37, 64> arr;
+    for (size_t i = 0; i < arr.size(); ++i) {
+        arr[i] = static_cast<float>(i);
+    }
+    std::span<const float> xs(arr.data(), arr.size());
+    EXPECT_EQ(simd::sum(xs), 666.0f);
+    EXPECT_EQ(simd::min(xs), 0.0f);
+    EXPECT_EQ(simd::count(xs, 36.0f), 1u);
+}
@@ -0,0 +1,120 @@
+#include "../stl/data-structure/SmallVector.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+TEST(SmallVectorTest, StaysInlineUpToN)
+{
+    SmallVector<int, 4> vector;
+    EXPECT_TRUE(vector.empty());
+    EXPECT_EQ(vector.capacity(), 4);
+
+    for (int i = 0; i < 4; ++i) {
+        vector.push_back(i);
+    }
+    EXPECT_TRUE(vector.is_inline());
+
+    vector.push_back(4); // spills
+    EXPECT_FALSE(vector.is_inline());
+    EXPECT_EQ(vector.size(), 5);
+    EXPECT_GE(vector.capacity(), 5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(vector[i], i);
+    }
+    EXPECT_THROW(vector[5], std::out_of_range);
+}
+
+TEST(SmallVectorTest, ParameterizedConstructor)
+{
+    SmallVector<std::string, 2> small(2);
+    EXPECT_TRUE(small.is_inline());
+    EXPECT_EQ(small[1], "");
+
+    SmallVector<std::string, 2> large(3);
+    EXPECT_FALSE(large.is_inline());
+    EXPECT_EQ(large.size(), 3);
+}
+
+TEST(SmallVectorTest, CopyInlineAndHeap)
+{
+    SmallVector<std::string, 2> inline_vec;
+    inline_vec.push_back("a");
+    SmallVector<std::string, 2> heap_vec;
+    for (const char *s : {"x", "y", "z"}) {
+        heap_vec.push_back(s);
+    }
+
+    SmallVector<std::string, 2> copy = heap_vec;
+    EXPECT_EQ(copy.size(), 3);
+    EXPECT_EQ(copy[2], "z");
+    heap_vec[2] = "changed";
+    EXPECT_EQ(copy[2], "z");
+
+    copy = inline_vec; // heap -> inline
+    EXPECT_TRUE(copy.is_inline());
+    EXPECT_EQ(copy.size(), 1);
+    EXPECT_EQ(copy[0], "a");
+}
+
+TEST(SmallVectorTest, MoveStealsHeapBuffer)
+{
+    SmallVector<int, 2> source;
+    for (int i = 0; i < 10; ++i) {
+        source.push_back(i);
+    }
+    const int *buffer = source.data();
+
+    SmallVector<int, 2> target(std::move(source));
+    EXPECT_EQ(target.data(), buffer);
+    EXPECT_EQ(target.size(), 10);
+    EXPECT_TRUE(source.empty());
+    EXPECT_TRUE(source.is_inline());
+
+    source.push_back(42); // the moved-from vector is usable
+    EXPECT_EQ(source[0], 42);
+}
+
+TEST(SmallVectorTest, MoveInlineElements)
+{
+    SmallVector<std::unique_ptr<int>, 4> source;
+    source.push_back(std::make_unique<int>(1));
+    source.push_back(std::make_unique<int>(2));
+
+    SmallVector<std::unique_ptr<int>, 4> target;
+    target.push_back(std::make_unique<int>(9));
+    target = std::move(source);
+    EXPECT_TRUE(target.is_inline());
+    EXPECT_EQ(target.size(), 2);
+    EXPECT_EQ(*target[1], 2);
+    EXPECT_TRUE(source.empty());
+
+    target.swap(source);
+    EXPECT_TRUE(target.empty());
+    EXPECT_EQ(*source[0], 1);
+}
+
+TEST(SmallVectorTest, PushBackAliasDuringSpill)
+{
+    SmallVector<std::string, 1> strings;
+    strings.push_back("long enough to live on the heap, not in the string");
+    strings.push_back(strings[0]);
+    strings.push_back(strings[1]);
+    EXPECT_EQ(strings[2], strings[0]);
+}
+
+TEST(SmallVectorTest, DestroysEveryElement)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        SmallVector<std::shared_ptr<int>, 3> vector;
+        for (int i = 0; i < 7; ++i) {
+            vector.push_back(counter);
+        }
+        EXPECT_EQ(counter.use_count(), 8);
+        vector.pop_back();
+        EXPECT_EQ(counter.use_count(), 7);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
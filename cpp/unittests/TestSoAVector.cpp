@@ -0,0 +1,97 @@
+#include "../stl/data-structure/SoAVector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <string>
+
+TEST(SoAVectorTest, PushBackAndAccess)
+{
+    SoAVector<int, double, std::string> records;
+    EXPECT_TRUE(records.empty());
+
+    for (int i = 0; i < 10; ++i) {
+        records.push_back(i, i * 0.5, std::to_string(i));
+    }
+    EXPECT_EQ(records.size(), 10);
+    EXPECT_GE(records.capacity(), 10);
+
+    auto [id, price, name] = records[7];
+    EXPECT_EQ(id, 7);
+    EXPECT_DOUBLE_EQ(price, 3.5);
+    EXPECT_EQ(name, "7");
+
+    price = 100; // references into the columns
+    EXPECT_DOUBLE_EQ(std::get<1>(records[7]), 100);
+    EXPECT_THROW(records[10], std::out_of_range);
+
+    records.pop_back();
+    EXPECT_EQ(records.size(), 9);
+}
+
+TEST(SoAVectorTest, ColumnsAreAlignedSpans)
+{
+    SoAVector<float, int64_t> records;
+    for (int i = 0; i < 100; ++i) {
+        records.push_back(static_cast<float>(i), i);
+    }
+
+    auto values = records.column<0>();
+    auto keys = records.column<1>();
+    EXPECT_EQ(values.size(), 100);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(values.data()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(keys.data()) % 64, 0u);
+    EXPECT_EQ(std::accumulate(keys.begin(), keys.end(), int64_t{0}), 4950);
+
+    for (float &v : values) {
+        v *= 2;
+    }
+    EXPECT_FLOAT_EQ(std::get<0>(records[99]), 198);
+}
+
+TEST(SoAVectorTest, ReserveKeepsRecords)
+{
+    SoAVector<std::string, int> records;
+    records.push_back("a", 1);
+    records.push_back("b", 2);
+
+    records.reserve(50);
+    EXPECT_EQ(records.capacity(), 50);
+    EXPECT_EQ(std::get<0>(records[1]), "b");
+
+    records.reserve(10); // does not shrink
+    EXPECT_EQ(records.capacity(), 50);
+}
+
+TEST(SoAVectorTest, CopyAndMove)
+{
+    SoAVector<std::string, int> records(3);
+    EXPECT_EQ(std::get<0>(records[2]), "");
+    std::get<0>(records[0]) = "first";
+
+    SoAVector<std::string, int> copy = records;
+    std::get<0>(records[0]) = "changed";
+    EXPECT_EQ(std::get<0>(copy[0]), "first");
+
+    SoAVector<std::string, int> moved = std::move(copy);
+    EXPECT_EQ(moved.size(), 3);
+    EXPECT_TRUE(copy.empty());
+
+    copy = moved;
+    EXPECT_EQ(std::get<0>(copy[0]), "first");
+    records = std::move(moved);
+    EXPECT_EQ(std::get<0>(records[0]), "first");
+}
+
+TEST(SoAVectorTest, PushBackOwnRecordDuringGrowth)
+{
+    SoAVector<std::string, int> records;
+    records.push_back("long enough to be stored on the heap by std::string", 1);
+    for (int i = 0; i < 8; ++i) {
+        const auto &[name, id] = records[0];
+        records.push_back(name, id); // reallocates while reading record 0
+    }
+    EXPECT_EQ(std::get<0>(records[8]), std::get<0>(records[0]));
+    EXPECT_EQ(std::get<1>(records[8]), 1);
+}
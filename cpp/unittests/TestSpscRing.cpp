@@ -0,0 +1,172 @@
+#include "../stl/data-structure/SpscRing.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SpscRingTest, CapacityRoundsUpToPowerOfTwo)
+{
+    EXPECT_EQ(SpscRing<int>(1).capacity(), 1);
+    EXPECT_EQ(SpscRing<int>(5).capacity(), 8);
+    EXPECT_EQ(SpscRing<int>(64).capacity(), 64);
+    EXPECT_THROW(SpscRing<int>(0), std::invalid_argument);
+}
+
+TEST(SpscRingTest, PushPopFifoAndFull)
+{
+    SpscRing<std::string> ring(4);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.try_pop().has_value());
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(ring.try_push(std::to_string(i)));
+    EXPECT_FALSE(ring.try_push("full"));
+    EXPECT_EQ(ring.size(), 4);
+
+    std::string value;
+    EXPECT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, "0");
+    EXPECT_TRUE(ring.try_push("4"));
+    for (int i = 1; i <= 4; ++i)
+        EXPECT_EQ(ring.try_pop(), std::to_string(i));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, BatchWriteAndReadWrapAround)
+{
+    SpscRing<int> ring(8);
+    std::vector<int> in{1, 2, 3, 4, 5, 6};
+    std::vector<int> out(8);
+
+    EXPECT_EQ(ring.write(in), 6);
+    EXPECT_EQ(ring.read(std::span<int>(out.data(), 4)), 4);
+    EXPECT_EQ(ring.write(in), 6); // 2 left + 6 = full, wraps past the end
+    EXPECT_EQ(ring.write(in), 0);
+
+    EXPECT_EQ(ring.read(out), 8);
+    EXPECT_EQ(out, (std::vector<int>{5, 6, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST(SpscRingTest, DestroysRemainingElements)
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        SpscRing<std::shared_ptr<int>> ring(4);
+        ring.try_push(tracker);
+        ring.try_push(tracker);
+        EXPECT_EQ(tracker.use_count(), 3);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+namespace
+{
+// Shares a tracker so leaked copies show up in use_count; the copy that
+// would make `throwAt` copies in total throws instead
+struct ThrowingCopy {
+    std::shared_ptr<int> tracker;
+    static inline int copies = 0;
+    static inline int throwAt = -1;
+
+    explicit ThrowingCopy(std::shared_ptr<int> t) : tracker(std::move(t)) {}
+    ThrowingCopy(const ThrowingCopy &other) : tracker(other.tracker)
+    {
+        if (++copies == throwAt)
+            throw std::runtime_error("copy failed");
+    }
+    ThrowingCopy(ThrowingCopy &&) = default;
+    ThrowingCopy &operator=(ThrowingCopy &&) = default;
+};
+
+// Same for move assignment, which read() uses to hand items out
+struct ThrowingMove {
+    std::shared_ptr<int> tracker;
+    static inline int moves = 0;
+    static inline int throwAt = -1;
+
+    explicit ThrowingMove(std::shared_ptr<int> t = nullptr) : tracker(std::move(t)) {}
+    ThrowingMove(const ThrowingMove &) = default;
+    ThrowingMove(ThrowingMove &&) noexcept = default;
+    ThrowingMove &operator=(ThrowingMove &&other)
+    {
+        if (++moves == throwAt)
+            throw std::runtime_error("move failed");
+        tracker = std::move(other.tracker);
+        return *this;
+    }
+};
+} // namespace
+
+TEST(SpscRingTest, ThrowingBatchWriteLeaksNothing)
+{
+    auto tracker = std::make_shared<int>(0);
+    std::vector<ThrowingCopy> items(4, ThrowingCopy(tracker));
+    SpscRing<ThrowingCopy> ring(8);
+
+    ThrowingCopy::copies = 0;
+    ThrowingCopy::throwAt = 3;
+    EXPECT_THROW(ring.write(items), std::runtime_error);
+    ThrowingCopy::throwAt = -1;
+    EXPECT_EQ(tracker.use_count(), 5); // the tracker and the four items
+    ThrowingCopy out(nullptr);
+    EXPECT_FALSE(ring.try_pop(out));
+
+    EXPECT_EQ(ring.write(items), 4);
+    EXPECT_EQ(tracker.use_count(), 9);
+}
+
+TEST(SpscRingTest, ThrowingBatchReadConsumesOnlyWhatMoved)
+{
+    auto tracker = std::make_shared<int>(0);
+    std::vector<ThrowingMove> items(4, ThrowingMove(tracker));
+    SpscRing<ThrowingMove> ring(8);
+    ASSERT_EQ(ring.write(items), 4);
+    items.clear();
+    EXPECT_EQ(tracker.use_count(), 5);
+
+    std::vector<ThrowingMove> out(4);
+    ThrowingMove::moves = 0;
+    ThrowingMove::throwAt = 3;
+    EXPECT_THROW(ring.read(out), std::runtime_error);
+    ThrowingMove::throwAt = -1;
+    // two moved out, the failed one and the last one still queued
+    EXPECT_EQ(ring.size(), 2);
+    EXPECT_EQ(tracker.use_count(), 5);
+
+    std::vector<ThrowingMove> rest(4);
+    EXPECT_EQ(ring.read(rest), 2);
+    EXPECT_EQ(rest[1].tracker, tracker);
+    out.clear();
+    rest.clear();
+    EXPECT_EQ(tracker.use_count(), 1); // nothing destroyed twice or leaked
+}
+
+TEST(SpscRingTest, TwoThreadsTransferInOrder)
+{
+    SpscRing<int> ring(64);
+    const int count = 200'000;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < count;) {
+            if (ring.try_push(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    while (expected < count) {
+        int value;
+        if (ring.try_pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,144 @@
+#include "../stl/data-structure/StaticVector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<StaticVector<int, 8>>);
+static_assert(std::is_trivially_destructible_v<StaticVector<int, 8>>);
+static_assert(!std::is_trivially_copyable_v<StaticVector<std::string, 8>>);
+static_assert(std::is_copy_constructible_v<StaticVector<std::string, 8>>);
+static_assert(!std::is_copy_constructible_v<StaticVector<std::unique_ptr<int>, 8>>);
+static_assert(std::is_nothrow_move_constructible_v<StaticVector<std::string, 8>>);
+static_assert(alignof(StaticVector<double, 3>) == alignof(double));
+
+TEST(StaticVectorTest, PushUpToCapacity)
+{
+    StaticVector<int, 4> vector;
+    EXPECT_TRUE(vector.empty());
+    EXPECT_EQ(vector.capacity(), 4);
+
+    for (int i = 0; i < 4; ++i) {
+        vector.push_back(i);
+    }
+    EXPECT_TRUE(vector.full());
+    EXPECT_THROW(vector.push_back(4), std::length_error);
+    EXPECT_EQ(vector.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(vector[i], i);
+    }
+    EXPECT_THROW(vector.at(4), std::out_of_range);
+}
+
+TEST(StaticVectorTest, TryPush)
+{
+    StaticVector<std::string, 2> vector;
+    EXPECT_TRUE(vector.try_push("a"));
+    std::string b = "b";
+    EXPECT_TRUE(vector.try_push(b));
+    EXPECT_FALSE(vector.try_push("c"));
+    EXPECT_EQ(vector.try_emplace_back(3, 'x'), nullptr);
+    EXPECT_EQ(vector.size(), 2);
+    EXPECT_EQ(vector[1], "b");
+
+    vector.pop_back();
+    std::string *added = vector.try_emplace_back(3, 'x');
+    ASSERT_NE(added, nullptr);
+    EXPECT_EQ(*added, "xxx");
+}
+
+TEST(StaticVectorTest, EmplaceConstructsInPlace)
+{
+    StaticVector<std::pair<int, std::string>, 3> vector;
+    auto &back = vector.emplace_back(1, "one");
+    EXPECT_EQ(&back, &vector[0]);
+    EXPECT_EQ(back.second, "one");
+}
+
+TEST(StaticVectorTest, ParameterizedConstructor)
+{
+    StaticVector<std::string, 3> vector(2);
+    EXPECT_EQ(vector.size(), 2);
+    EXPECT_EQ(vector[1], "");
+    EXPECT_THROW((StaticVector<int, 3>(4)), std::length_error);
+}
+
+TEST(StaticVectorTest, CopyAndMove)
+{
+    StaticVector<std::string, 4> a;
+    a.push_back("x");
+    a.push_back("y");
+
+    StaticVector<std::string, 4> b = a;
+    EXPECT_EQ(b.size(), 2);
+    EXPECT_EQ(b[1], "y");
+
+    StaticVector<std::string, 4> c = std::move(a);
+    EXPECT_EQ(c[0], "x");
+
+    StaticVector<std::string, 4> d;
+    d.push_back("old");
+    d.push_back("old");
+    d.push_back("old");
+    d = b;
+    EXPECT_EQ(d.size(), 2);
+    EXPECT_EQ(d[0], "x");
+
+    d = std::move(c);
+    EXPECT_EQ(d[1], "y");
+}
+
+TEST(StaticVectorTest, MoveOnlyElements)
+{
+    StaticVector<std::unique_ptr<int>, 2> a;
+    a.push_back(std::make_unique<int>(5));
+    StaticVector<std::unique_ptr<int>, 2> b = std::move(a);
+    EXPECT_EQ(*b[0], 5);
+}
+
+TEST(StaticVectorTest, Memcpy)
+{
+    StaticVector<int, 8> vector;
+    vector.push_back(3);
+    vector.push_back(4);
+
+    unsigned char message[sizeof(vector)];
+    std::memcpy(message, &vector, sizeof(vector));
+    StaticVector<int, 8> copy;
+    std::memcpy(&copy, message, sizeof(copy));
+    EXPECT_EQ(copy.size(), 2);
+    EXPECT_EQ(copy[1], 4);
+}
+
+TEST(StaticVectorTest, DestroysElements)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        StaticVector<std::shared_ptr<int>, 4> vector;
+        vector.push_back(counter);
+        vector.push_back(counter);
+        EXPECT_EQ(counter.use_count(), 3);
+        vector.pop_back();
+        EXPECT_EQ(counter.use_count(), 2);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(StaticVectorTest, Iteration)
+{
+    StaticVector<int, 5> vector;
+    for (int i = 1; i <= 5; ++i) {
+        vector.push_back(i);
+    }
+    int sum = 0;
+    for (int x : vector) {
+        sum += x;
+    }
+    EXPECT_EQ(sum, 15);
+    vector.clear();
+    EXPECT_EQ(vector.begin(), vector.end());
+    EXPECT_THROW(vector.pop_back(), std::out_of_range);
+}
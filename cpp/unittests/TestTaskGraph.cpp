@@ -0,0 +1,121 @@
+#include "../concurrency/threadpool.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <vector>
+
+TEST(TaskGraphTest, EmptyGraphCompletes)
+{
+    ThreadPool pool(2);
+    TaskGraph graph;
+    EXPECT_NO_THROW(pool.run(graph).get());
+}
+
+TEST(TaskGraphTest, RespectsDependencies)
+{
+    ThreadPool pool(4);
+    TaskGraph graph;
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) {
+        return [&, id] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+        };
+    };
+
+    // diamond: 0 -> {1, 2} -> 3
+    auto a = graph.add(record(0));
+    auto b = graph.add(record(1));
+    auto c = graph.add(record(2));
+    auto d = graph.add(record(3));
+    graph.precede(a, b);
+    graph.precede(a, c);
+    graph.precede(b, d);
+    graph.precede(c, d);
+
+    pool.run(graph).get();
+
+    ASSERT_EQ(order.size(), 4);
+    EXPECT_EQ(order.front(), 0);
+    EXPECT_EQ(order.back(), 3);
+}
+
+TEST(TaskGraphTest, GraphIsReusable)
+{
+    ThreadPool pool(2);
+    TaskGraph graph;
+    std::atomic<int> counter{0};
+    auto first = graph.add([&counter] { ++counter; });
+    for (int i = 0; i < 10; ++i)
+        graph.precede(first, graph.add([&counter] { ++counter; }));
+
+    for (int run = 0; run < 5; ++run)
+        pool.run(graph).get();
+    EXPECT_EQ(counter, 55);
+    EXPECT_FALSE(graph.running());
+}
+
+TEST(TaskGraphTest, LongChainRunsInOrder)
+{
+    ThreadPool pool(3);
+    TaskGraph graph;
+    std::vector<int> values;
+    TaskGraph::NodeId previous = graph.add([&values] { values.push_back(0); });
+    for (int i = 1; i < 1000; ++i) {
+        auto node = graph.add([&values, i] { values.push_back(i); });
+        graph.precede(previous, node);
+        previous = node;
+    }
+
+    pool.run(graph).get();
+    ASSERT_EQ(values.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(values[i], i);
+}
+
+TEST(TaskGraphTest, FailureSkipsRemainingWorkAndPropagates)
+{
+    ThreadPool pool(2);
+    TaskGraph graph;
+    bool ranAfter = false;
+    auto bad = graph.add([] { throw std::runtime_error("node failed"); });
+    auto after = graph.add([&ranAfter] { ranAfter = true; });
+    graph.precede(bad, after);
+
+    EXPECT_THROW(pool.run(graph).get(), std::runtime_error);
+    EXPECT_FALSE(ranAfter);
+}
+
+TEST(TaskGraphTest, RejectsCyclesAndBadNodes)
+{
+    ThreadPool pool(1);
+    TaskGraph graph;
+    auto a = graph.add([] {});
+    auto b = graph.add([] {});
+    graph.precede(a, b);
+    graph.precede(b, a);
+
+    EXPECT_THROW(graph.precede(a, 7), std::out_of_range);
+    EXPECT_THROW(pool.run(graph), std::logic_error);
+    EXPECT_FALSE(graph.running());
+}
+
+TEST(TaskGraphTest, BadLaneLeavesGraphReusable)
+{
+    ThreadPool pool(2);
+    TaskGraph graph;
+    std::atomic<int> ran{0};
+    auto a = graph.add([&] { ++ran; });
+    auto b = graph.add([&] { ++ran; });
+    graph.precede(a, b);
+    graph.add([&] { ++ran; }); // second root
+
+    EXPECT_THROW(pool.run(graph, pool.lanes()), std::out_of_range);
+    EXPECT_FALSE(graph.running());
+    EXPECT_EQ(ran, 0);
+
+    EXPECT_NO_THROW(pool.run(graph, ThreadPool::Low).get());
+    EXPECT_EQ(ran, 3);
+}
@@ -0,0 +1,353 @@
+#include "../concurrency/threadpool.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <vector>
+
+// Keeps the only worker of a pool busy until released, so that the tests
+// can queue up work and observe the order in which it is picked.
+struct WorkerGate {
+    std::promise<void> started;
+    std::promise<void> release;
+
+    void block(ThreadPool &pool)
+    {
+        auto released = release.get_future().share();
+        pool.submit(ThreadPool::High, [this, released] {
+            started.set_value();
+            released.wait();
+        });
+        started.get_future().wait();
+    }
+
+    void open() { release.set_value(); }
+};
+
+TEST(ThreadPoolTest, SubmitReturnsResult)
+{
+    ThreadPool pool(2);
+    auto result = pool.submit([] { return 40 + 2; });
+    EXPECT_EQ(result.get(), 42);
+}
+
+TEST(ThreadPoolTest, SubmitPropagatesException)
+{
+    ThreadPool pool(1);
+    auto result = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, DestructorDrainsQueuedTasks)
+{
+    std::atomic<int> counter{0};
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 100; ++i)
+            pool.submit([&counter] { ++counter; });
+    }
+    EXPECT_EQ(counter, 100);
+}
+
+TEST(ThreadPoolTest, InvalidLaneThrows)
+{
+    ThreadPool pool(1);
+    EXPECT_THROW(pool.submit(pool.lanes(), [] {}), std::out_of_range);
+    EXPECT_THROW(pool.queue_wait(pool.lanes()), std::out_of_range);
+}
+
+TEST(ThreadPoolTest, StrictPriorityBetweenLanes)
+{
+    ThreadPool pool(1);
+    WorkerGate gate;
+    gate.block(pool);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) {
+        return [&, id] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+        };
+    };
+
+    pool.submit(ThreadPool::Low, record(2));
+    pool.submit(ThreadPool::Normal, record(1));
+    auto last = pool.submit(ThreadPool::High, record(0));
+    gate.open();
+    last.get();
+    pool.submit(ThreadPool::Low, [] {}).get();
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(ThreadPoolTest, AgingServesStarvedLane)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.agingQuota = 2;
+    ThreadPool pool(options);
+    WorkerGate gate;
+    gate.block(pool);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) {
+        return [&, id] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+        };
+    };
+
+    pool.submit(ThreadPool::Low, record(-1));
+    for (int i = 0; i < 4; ++i)
+        pool.submit(ThreadPool::High, record(i));
+    gate.open();
+    pool.submit(ThreadPool::Low, [] {}).get();
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, -1, 2, 3}));
+}
+
+TEST(ThreadPoolTest, EarliestDeadlineFirstWithinLane)
+{
+    ThreadPool pool(1);
+    WorkerGate gate;
+    gate.block(pool);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    auto record = [&](int id) {
+        return [&, id] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(id);
+        };
+    };
+
+    auto now = ThreadPool::Clock::now();
+    pool.submit(ThreadPool::Normal, record(3));
+    pool.submit(ThreadPool::Normal, now + std::chrono::seconds(3), record(2));
+    pool.submit(ThreadPool::Normal, now + std::chrono::seconds(1), record(0));
+    pool.submit(ThreadPool::Normal, now + std::chrono::seconds(2), record(1));
+    gate.open();
+    pool.submit(ThreadPool::Low, [] {}).get();
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(ThreadPoolTest, QueueWaitHistogramPerLane)
+{
+    ThreadPool pool(1);
+    for (int i = 0; i < 10; ++i)
+        pool.submit(ThreadPool::High, [] {}).get();
+    pool.submit(ThreadPool::Low, [] {}).get();
+
+    EXPECT_EQ(pool.queue_wait(ThreadPool::High).count(), 10);
+    EXPECT_EQ(pool.queue_wait(ThreadPool::Normal).count(), 0);
+    EXPECT_EQ(pool.queue_wait(ThreadPool::Low).count(), 1);
+    EXPECT_GE(pool.queue_wait(ThreadPool::High).percentile(99),
+              pool.queue_wait(ThreadPool::High).percentile(50));
+}
+
+TEST(LatencyHistogramTest, PercentileWithinBucketPrecision)
+{
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 1000; ++v)
+        histogram.record(v);
+
+    EXPECT_EQ(histogram.count(), 1000);
+    auto p50 = histogram.percentile(50);
+    EXPECT_GE(p50, 500);
+    EXPECT_LE(p50, 500 + 500 / LatencyHistogram::SubBuckets);
+    EXPECT_GE(histogram.max(), 1000);
+}
+
+TEST(ThreadPoolTest, ElasticPoolGrowsAndShrinks)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.minWorkers = 1;
+    options.maxWorkers = 4;
+    options.idleTimeout = std::chrono::milliseconds(50);
+    options.monitorInterval = std::chrono::milliseconds(1);
+    options.maxQueueWait = std::chrono::microseconds(100);
+    ThreadPool pool(options);
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::vector<std::future<void>> results;
+    for (int i = 0; i < 4; ++i)
+        results.push_back(pool.submit([released] { released.wait(); }));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pool.size() < 4 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(pool.size(), 4);
+
+    release.set_value();
+    for (auto &result : results)
+        result.get();
+
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pool.size() > 1 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_EQ(pool.submit([] { return 1; }).get(), 1);
+}
+
+TEST(ThreadPoolTest, BlockingSectionSpawnsCompensatingWorker)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.maxWorkers = 2;
+    options.monitorInterval = std::chrono::hours(1); // only the hint may grow it
+    ThreadPool pool(options);
+
+    std::promise<int> inner;
+    auto outer = pool.submit([&pool, &inner] {
+        EXPECT_EQ(ThreadPool::current(), &pool);
+        blocking_section blocking;
+        pool.submit([&inner] { inner.set_value(5); });
+        return inner.get_future().get();
+    });
+
+    EXPECT_EQ(outer.get(), 5);
+    EXPECT_EQ(pool.size(), 2);
+    EXPECT_EQ(ThreadPool::current(), nullptr);
+}
+
+// Two live workers, one of them blocked, and two queued tasks: the backlog
+// exceeds the workers that can actually run, so the monitor grows the pool
+TEST(ThreadPoolTest, MonitorDiscountsBlockedWorkers)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.maxWorkers = 3;
+    options.monitorInterval = std::chrono::milliseconds(1);
+    options.maxQueueWait = std::chrono::hours(1); // only the backlog rule applies
+
+    // declared before the pool so they outlive its workers
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> blockedStarted, busyStarted;
+    ThreadPool pool(options);
+    pool.post([&] {
+        blocking_section blocking; // spawns the second worker
+        blockedStarted.set_value();
+        released.wait();
+    });
+    blockedStarted.get_future().wait();
+    pool.post([&] {
+        busyStarted.set_value();
+        released.wait();
+    });
+    busyStarted.get_future().wait();
+
+    auto a = pool.submit([] { return 1; });
+    auto b = pool.submit([] { return 2; });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pool.size() < 3 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(pool.size(), 3);
+    release.set_value();
+    EXPECT_EQ(a.get() + b.get(), 3);
+}
+
+// Polled every 500us, 200ms of idling would be about 400 calls; doubling
+// up to 20ms brings it down to about 15
+TEST(ThreadPoolTest, IdlePollBacksOff)
+{
+    std::atomic<int> polls{0};
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.onIdle = [&polls] {
+        ++polls;
+        return false;
+    };
+    ThreadPool pool(options);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    int idlePolls = polls.load();
+    EXPECT_GT(idlePolls, 0);
+    EXPECT_LT(idlePolls, 50);
+
+    // a push still wakes the worker right away
+    EXPECT_EQ(pool.submit([] { return 7; }).get(), 7);
+}
+
+TEST(ThreadPoolTest, InvalidWorkerBoundsThrow)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 4;
+    options.maxWorkers = 2;
+    EXPECT_THROW(ThreadPool pool(options), std::invalid_argument);
+}
+
+TEST(ThreadPoolTest, SpinningWorkersPickUpWorkWithoutNotify)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 2;
+    options.spin = SpinPolicy{1 << 16, 64};
+    ThreadPool pool(options);
+
+    // ping-pong: every task is submitted right after the previous finished,
+    // while the workers are still spinning
+    int value = 0;
+    for (int i = 0; i < 200; ++i)
+        value = pool.submit([value] { return value + 1; }).get();
+    EXPECT_EQ(value, 200);
+}
+
+TEST(ThreadPoolTest, TelemetryCountsTasksAndRunTime)
+{
+    ThreadPool pool(2);
+    for (int i = 0; i < 100; ++i)
+        pool.submit([] { std::this_thread::sleep_for(std::chrono::microseconds(10)); }).get();
+
+    // the counters are updated right after the task, i.e. after its future
+    auto deadline = ThreadPool::Clock::now() + std::chrono::seconds(5);
+    auto snapshot = pool.telemetry();
+    while (snapshot.total().tasks < 100 && ThreadPool::Clock::now() < deadline) {
+        std::this_thread::yield();
+        snapshot = pool.telemetry();
+    }
+
+    EXPECT_EQ(snapshot.workers.size(), 2);
+    EXPECT_EQ(snapshot.total().tasks, 100);
+    EXPECT_EQ(snapshot.runTime.count(), 100);
+    EXPECT_GE(snapshot.runTime.percentile(50), 10'000);
+    EXPECT_GE(snapshot.total().busy, std::chrono::microseconds(1000));
+    EXPECT_GT(snapshot.total().idle, ThreadPool::Clock::duration::zero());
+    ASSERT_EQ(snapshot.queueWait.size(), pool.lanes());
+    EXPECT_EQ(snapshot.queueWait[ThreadPool::Normal].count(), 100);
+}
+
+TEST(ThreadPoolTest, TelemetryHookRunsPeriodically)
+{
+    std::promise<size_t> dumped;
+    std::atomic<bool> once{false};
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.telemetryInterval = std::chrono::milliseconds(1);
+    options.onTelemetry = [&](const ThreadPool::TelemetrySnapshot &snapshot) {
+        if (!once.exchange(true))
+            dumped.set_value(snapshot.workers.size());
+    };
+    ThreadPool pool(options);
+
+    auto workers = dumped.get_future();
+    ASSERT_EQ(workers.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(workers.get(), 1);
+}
+
+TEST(ThreadPoolTest, SubmitBulkRunsEveryTask)
+{
+    ThreadPool pool(2);
+    std::vector<std::function<int()>> tasks;
+    for (int i = 0; i < 1000; ++i)
+        tasks.push_back([i] { return i * 2; });
+
+    auto futures = pool.submit_bulk(tasks);
+    ASSERT_EQ(futures.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(futures[i].get(), i * 2);
+}
@@ -0,0 +1,148 @@
+#include "../concurrency/threadpool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(TimerWheelTest, ScheduleAfterFiresOnceAfterDelay)
+{
+    ThreadPool pool(1);
+    std::promise<ThreadPool::Clock::time_point> fired;
+    auto start = ThreadPool::Clock::now();
+    pool.schedule_after(20ms, [&fired] { fired.set_value(ThreadPool::Clock::now()); });
+
+    auto when = fired.get_future();
+    ASSERT_EQ(when.wait_for(5s), std::future_status::ready);
+    EXPECT_GE(when.get() - start, 20ms);
+    EXPECT_EQ(pool.timers(), 0);
+}
+
+TEST(TimerWheelTest, ScheduleEveryRepeatsUntilCancelled)
+{
+    ThreadPool pool(1);
+    std::atomic<int> count{0};
+    std::promise<void> thrice;
+    auto id = pool.schedule_every(2ms, [&] {
+        if (++count == 3)
+            thrice.set_value();
+    });
+
+    ASSERT_EQ(thrice.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_TRUE(pool.cancel(id));
+    EXPECT_FALSE(pool.cancel(id));
+    EXPECT_EQ(pool.timers(), 0);
+}
+
+TEST(TimerWheelTest, CancelledTimerNeverFires)
+{
+    ThreadPool pool(1);
+    std::atomic<bool> fired{false};
+    auto id = pool.schedule_after(10ms, [&fired] { fired = true; });
+    EXPECT_TRUE(pool.cancel(id));
+
+    std::promise<void> later;
+    pool.schedule_after(30ms, [&later] { later.set_value(); });
+    ASSERT_EQ(later.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_FALSE(fired);
+}
+
+TEST(TimerWheelTest, TimersBeyondOneLapAndInOrder)
+{
+    ThreadPool::Options options;
+    options.numberOfWorker = 1;
+    options.timerSlots = 4; // 4 ticks per lap, so most timers take several laps
+    ThreadPool pool(options);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::promise<void> done;
+    for (int i = 5; i >= 1; --i) {
+        pool.schedule_after(i * 5ms, [&, i] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+            if (order.size() == 5)
+                done.set_value();
+        });
+    }
+    ASSERT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+// The timer thread sleeps until the hour-long timer; the sooner one added
+// afterwards has to wake it
+TEST(TimerWheelTest, SoonerTimerWakesSleepingThread)
+{
+    ThreadPool pool(1);
+    auto far = pool.schedule_after(1h, [] {});
+    std::this_thread::sleep_for(5ms);
+
+    std::promise<void> fired;
+    auto start = ThreadPool::Clock::now();
+    pool.schedule_after(10ms, [&fired] { fired.set_value(); });
+    ASSERT_EQ(fired.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_LT(ThreadPool::Clock::now() - start, 1s);
+    EXPECT_TRUE(pool.cancel(far));
+}
+
+TEST(TimerWheelTest, ManyPendingTimersCancelInConstantTime)
+{
+    ThreadPool pool(1);
+    std::vector<TimerId> ids;
+    for (int i = 0; i < 100'000; ++i)
+        ids.push_back(pool.schedule_after(1h + i * 1ms, [] {}));
+    EXPECT_EQ(pool.timers(), 100'000);
+
+    for (auto id : ids)
+        EXPECT_TRUE(pool.cancel(id));
+    EXPECT_EQ(pool.timers(), 0);
+
+    // freed nodes are reused and old handles do not match them
+    auto reused = pool.schedule_after(1h, [] {});
+    EXPECT_FALSE(pool.cancel(ids.back()));
+    EXPECT_TRUE(pool.cancel(reused));
+}
+
+TEST(TimerWheelTest, AddAfterStopReturnsInvalidHandle)
+{
+    ThreadPool pool(1);
+    TimerWheel wheel(pool, 1ms, 16);
+    TimerId live = wheel.add(0, 1h, 0ms, [] {});
+    EXPECT_TRUE(live.valid());
+
+    wheel.stop();
+    std::atomic<bool> fired{false};
+    TimerId dropped = wheel.add(0, 0ms, 0ms, [&fired] { fired = true; });
+    EXPECT_FALSE(dropped.valid());
+    EXPECT_FALSE(wheel.cancel(dropped));
+    EXPECT_FALSE(wheel.cancel(TimerId{}));
+    EXPECT_EQ(wheel.size(), 0);
+    std::this_thread::sleep_for(5ms);
+    EXPECT_FALSE(fired);
+}
+
+// A timer that re-arms itself keeps calling schedule_after while the pool
+// shuts down; the late calls get invalid handles instead of throwing
+TEST(TimerWheelTest, RearmingDuringShutdownIsDropped)
+{
+    std::atomic<int> firings{0};
+    std::atomic<int> invalid{0};
+    {
+        std::function<void()> rearm; // outlives the pool's workers
+        ThreadPool pool(2);
+        rearm = [&] {
+            ++firings;
+            if (!pool.schedule_after(1ms, rearm).valid())
+                ++invalid;
+        };
+        pool.schedule_after(1ms, rearm);
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (firings < 3 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_GE(firings, 3);
+    EXPECT_LE(invalid, 1);
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 struct TestObject {
     int value;
     explicit TestObject(int val = 0) : value(val) {}
@@ -211,3 +213,153 @@ TEST_F(VectorTest, Destructor)
     Vector<TestObject> *vector = new Vector<TestObject>(EXPECTED_SIZE);
     delete vector; // Should not crash or leak memory
 }
+
+// Counts constructions and destructions of live objects
+struct Tracked {
+    static inline int live = 0;
+    static inline int copies = 0;
+    static inline int moves = 0;
+
+    int value;
+    explicit Tracked(int val) : value(val) { ++live; }
+    Tracked(const Tracked &other) : value(other.value)
+    {
+        ++live;
+        ++copies;
+    }
+    Tracked(Tracked &&other) noexcept : value(other.value)
+    {
+        ++live;
+        ++moves;
+    }
+    Tracked &operator=(const Tracked &) = default;
+    ~Tracked() { --live; }
+
+    static void reset() { live = copies = moves = 0; }
+};
+
+// Moving may throw, so growth must copy instead
+struct ThrowingMove {
+    static inline int moves = 0;
+
+    int value;
+    explicit ThrowingMove(int val) : value(val) {}
+    ThrowingMove(const ThrowingMove &) = default;
+    ThrowingMove(ThrowingMove &&other) : value(other.value) { ++moves; }
+};
+
+// ✅ **Test Types Without a Default Constructor**
+TEST_F(VectorTest, NonDefaultConstructible)
+{
+    Tracked::reset();
+    {
+        Vector<Tracked> vector;
+        vector.reserve(8);
+        EXPECT_EQ(Tracked::live, 0); // Reserved slots hold no objects
+
+        for (int i = 0; i < 4; ++i) {
+            vector.emplace_back(i);
+        }
+        EXPECT_EQ(Tracked::live, 4);
+        EXPECT_EQ(Tracked::copies + Tracked::moves, 0); // Built in place
+
+        vector.pop_back();
+        EXPECT_EQ(Tracked::live, 3);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// ✅ **Test Growth Moves noexcept-Movable Elements**
+TEST_F(VectorTest, GrowthMovesElements)
+{
+    Tracked::reset();
+    {
+        Vector<Tracked> vector;
+        for (int i = 0; i < 100; ++i) {
+            vector.emplace_back(i);
+        }
+        EXPECT_EQ(Tracked::copies, 0);
+        EXPECT_GT(Tracked::moves, 0);
+        EXPECT_EQ(Tracked::live, 100);
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_EQ(vector[i].value, i);
+        }
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+// ✅ **Test Growth Copies When Moving May Throw**
+TEST_F(VectorTest, GrowthCopiesThrowingMove)
+{
+    ThrowingMove::moves = 0;
+    Vector<ThrowingMove> vector;
+    for (int i = 0; i < 20; ++i) {
+        vector.push_back(ThrowingMove(i)); // One move into the vector each
+    }
+    EXPECT_EQ(ThrowingMove::moves, 20);
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(vector[i].value, i);
+    }
+}
+
+// ✅ **Test Pushing an Element of the Vector Itself**
+TEST_F(VectorTest, PushBackAliasDuringGrowth)
+{
+    Vector<std::string> strings;
+    strings.push_back("first element, too long for small-string storage");
+    for (int i = 0; i < 10; ++i) {
+        strings.push_back(strings[0]); // Reallocates while reading strings[0]
+    }
+    EXPECT_EQ(strings[10], strings[0]);
+
+    Vector<int> ints;
+    ints.push_back(7);
+    for (int i = 0; i < 10; ++i) {
+        ints.push_back(ints[0]);
+    }
+    EXPECT_EQ(ints[10], 7);
+}
+
+// ✅ **Test Nested Vectors Relocate Bytewise**
+TEST_F(VectorTest, NestedVectorsAreRelocatable)
+{
+    static_assert(is_trivially_relocatable<int>::value);
+    static_assert(is_trivially_relocatable<Vector<std::string>>::value);
+    static_assert(!is_trivially_relocatable<std::string>::value);
+
+    Vector<Vector<int>> rows;
+    for (int i = 0; i < 50; ++i) {
+        Vector<int> &row = rows.emplace_back();
+        for (int j = 0; j <= i; ++j) {
+            row.push_back(j);
+        }
+    }
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(rows[i].size(), i + 1);
+        EXPECT_EQ(rows[i][i], i);
+    }
+
+    Vector<Vector<int>> copy = rows;
+    rows[0][0] = 42;
+    EXPECT_EQ(copy[0][0], 0);
+}
+
+// ✅ **Test Iteration and clear()**
+TEST_F(VectorTest, IterateAndClear)
+{
+    Vector<int> vector;
+    for (int i = 1; i <= 4; ++i) {
+        vector.push_back(i);
+    }
+
+    int sum = 0;
+    for (int value : vector) {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 10);
+
+    vector.clear();
+    EXPECT_TRUE(vector.empty());
+    EXPECT_EQ(vector.capacity(), 4);
+    EXPECT_THROW(vector.pop_back(), std::out_of_range);
+}